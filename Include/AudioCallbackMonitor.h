@@ -0,0 +1,86 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * @class AudioCallbackMonitor
+ * @brief Mide cada callback de audio contra su plazo (duración del buffer)
+ *
+ * El hilo de audio es el único escritor: registra la duración de cada
+ * callback con el reloj monotónico de alta resolución y la compara con el
+ * periodo del buffer. Todo el estado son atómicos, así que la GUI puede leer
+ * el histograma, los excesos de plazo y el peor bloque sin bloquear al audio.
+ * Los excesos medidos aquí son sobrecarga de DSP; los xruns que reporta el
+ * dispositivo se cuentan aparte para poder distinguir ambos casos.
+ */
+class AudioCallbackMonitor
+{
+public:
+    // Histograma por carga (duración / plazo) en pasos del 5 %, hasta el 200 %
+    static constexpr int numBuckets = 41;
+    static constexpr double bucketWidthPercent = 5.0;
+
+    struct WorstCallback
+    {
+        double durationMs = 0.0;
+        double deadlineMs = 0.0;
+        int numSamples = 0;
+        juce::int64 callbackIndex = 0;
+        juce::int64 wallClockMillis = 0;
+    };
+
+    struct Snapshot
+    {
+        juce::int64 numCallbacks = 0;
+        juce::int64 numOverruns = 0;
+        double lastLoadPercent = 0.0;
+        double averageLoadPercent = 0.0;
+        double sampleRate = 0.0;
+        WorstCallback worst;
+        std::array<juce::int64, numBuckets> histogram {};
+    };
+
+    AudioCallbackMonitor();
+
+    // Fuera del hilo de audio, antes de arrancar el dispositivo
+    void prepare(double sampleRate);
+
+    // Cualquier hilo: pide el reinicio, que aplica el siguiente callback
+    void reset();
+
+    // Hilo de audio: marcas del reloj monotónico al inicio y al final del callback
+    void recordCallback(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept;
+
+    // Cualquier hilo
+    Snapshot getSnapshot() const;
+
+    // Texto para la consola y CSV para exportar
+    static juce::String describe(const Snapshot& snapshot, int deviceXRuns);
+    static juce::String toCSV(const Snapshot& snapshot, int deviceXRuns);
+
+private:
+    void clearStatistics() noexcept;
+
+    std::atomic<bool> resetRequested { false };
+    std::atomic<double> currentSampleRate { 0.0 };
+    double secondsPerTick = 0.0;
+
+    std::atomic<juce::int64> numCallbacks { 0 };
+    std::atomic<juce::int64> numOverruns { 0 };
+    std::atomic<double> lastLoad { 0.0 };
+    std::atomic<double> loadSum { 0.0 };
+    std::array<std::atomic<juce::int64>, numBuckets> histogram;
+
+    // Peor bloque, publicado con un contador de versión (impar = escribiendo)
+    std::atomic<juce::uint32> worstVersion { 0 };
+    std::atomic<double> worstLoad { 0.0 };
+    std::atomic<double> worstDurationMs { 0.0 };
+    std::atomic<double> worstDeadlineMs { 0.0 };
+    std::atomic<int> worstNumSamples { 0 };
+    std::atomic<juce::int64> worstCallbackIndex { 0 };
+    std::atomic<juce::int64> worstWallClockMillis { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMonitor)
+};
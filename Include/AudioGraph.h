@@ -0,0 +1,248 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_events/juce_events.h>
+#include "AudioRenderThreadPool.h"
+#include "AudioScratchArena.h"
+#include "ParameterTable.h"
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+/**
+ * @class AudioGraphNode
+ * @brief Nodo de procesamiento dentro del grafo de audio del motor
+ *
+ * El grafo suma en el buffer del nodo las salidas de todos los nodos
+ * conectados a su entrada y después llama a process(), que trabaja in-place.
+ * Los buffers temporales se piden al AudioScratchArena que recibe process(),
+ * nunca con AudioBuffers locales.
+ *
+ * Silencio: un nodo que declara una cola finita (getTailSamples()) deja de
+ * procesarse cuando su entrada lleva en silencio más que esa cola y ningún
+ * parámetro suyo ha cambiado; su salida se marca como silencio para los nodos
+ * que le siguen. Se despierta en el mismo bloque en que llega señal o un evento.
+ */
+class AudioGraphNode
+{
+public:
+    virtual ~AudioGraphNode() = default;
+
+    // Nombre descriptivo para la consola y el editor de flujo
+    virtual juce::String getName() const = 0;
+
+    // Se llama fuera del hilo de audio antes de que el nodo entre en una secuencia
+    virtual void prepare(double sampleRate, int maximumBlockSize) = 0;
+
+    // Hilo de audio: sin locks ni reservas de memoria. El arena se vacía antes
+    // de cada llamada y tiene sitio para scratchBuffersPerNode buffers del bloque.
+    virtual void process(juce::AudioBuffer<float>& buffer, AudioScratchArena& scratch) = 0;
+
+    virtual void reset() {}
+
+    // IDs de la ParameterTable que lee este nodo. El grafo sólo le notifica los
+    // que cambiaron, así que los coeficientes se recalculan únicamente entonces.
+    virtual std::vector<ParameterTable::ParameterID> getParameterIDs() const { return {}; }
+
+    // Hilo de audio, antes de process(): un parámetro suscrito cambió de valor
+    virtual void parameterChanged(ParameterTable::ParameterID parameterID, float newValue)
+    {
+        juce::ignoreUnused(parameterID, newValue);
+    }
+
+    // Hilo de audio, antes de process(): valores muestra a muestra de un parámetro
+    // automatizado con rampa durante este bloque. Los nodos que no interpolan
+    // por sí mismos reciben por defecto el valor final del bloque.
+    virtual void parameterRamp(ParameterTable::ParameterID parameterID, const float* values, int numSamples)
+    {
+        parameterChanged(parameterID, values[numSamples - 1]);
+    }
+
+    // Latencia que introduce el nodo (lookahead, oversampling, fase lineal...)
+    int getLatencySamples() const noexcept { return latencySamples.load(std::memory_order_acquire); }
+
+    static constexpr int infiniteTail = std::numeric_limits<int>::max();
+
+    // Hilo de audio: muestras que el nodo sigue sonando tras quedarse su
+    // entrada en silencio (reverb, delay, release...). Por defecto infinita:
+    // los generadores y los nodos que no la declaran nunca se duermen.
+    virtual int getTailSamples() const { return infiniteTail; }
+
+    // Hilo de audio, dentro de process(): toda la entrada de este bloque está
+    // por debajo del umbral de silencio (el nodo sólo está reproduciendo su cola)
+    bool isInputSilent() const noexcept { return inputSilent; }
+
+protected:
+    // Cualquier hilo, incluido el de audio: el grafo recompila la compensación
+    // de retardo en segundo plano, nunca dentro del callback
+    void setLatencySamples(int newLatency) noexcept
+    {
+        newLatency = juce::jmax(0, newLatency);
+
+        if (latencySamples.exchange(newLatency, std::memory_order_acq_rel) == newLatency)
+            return;
+
+        if (auto* flag = latencyChangedFlag.load(std::memory_order_acquire))
+            flag->store(true, std::memory_order_release);
+    }
+
+private:
+    friend class AudioGraph;
+
+    std::atomic<int> latencySamples { 0 };
+    std::atomic<std::atomic<bool>*> latencyChangedFlag { nullptr };
+
+    // Estado del hilo de audio, lo escribe el grafo
+    bool inputSilent = false;
+    bool wakeRequested = false;
+};
+
+/**
+ * @class AudioGraph
+ * @brief Grafo de nodos compilado a una secuencia de render plana
+ *
+ * El modelo (nodos y conexiones) se edita desde el hilo de mensajes. Cada
+ * cambio se compila fuera del hilo de audio en una RenderSequence ordenada
+ * topológicamente, con todos sus buffers ya reservados, y se publica con un
+ * único intercambio atómico de puntero. El hilo de audio recoge la secuencia
+ * nueva al inicio del siguiente callback y entrega la anterior a un hilo de
+ * fondo que la libera, así que editar el ruteo en reproducción nunca bloquea
+ * ni reserva memoria en el callback.
+ *
+ * Si el grafo tiene ramas independientes, la secuencia se ejecuta en paralelo
+ * sobre un AudioRenderThreadPool; una sola cadena se procesa en el callback.
+ *
+ * Compensación de latencia: al compilar se calcula la latencia acumulada en
+ * cada nodo y se insertan líneas de retardo (ya reservadas) en las entradas
+ * que llegan antes, de modo que todas las ramas se suman alineadas. Cuando
+ * un nodo cambia su latencia, un hilo de fondo recompila la secuencia.
+ *
+ * Cada buffer de la secuencia lleva una marca de silencio: la entrada del
+ * dispositivo y las entradas sumadas de cada nodo se miden con un barrido de
+ * pico vectorizado, y los nodos dormidos dejan su buffer a cero y marcado, así
+ * que los nodos siguientes ni siquiera suman esas entradas.
+ */
+class AudioGraph : private juce::AsyncUpdater
+{
+public:
+    using NodeID = juce::uint32;
+
+    // Nodos especiales: entrada del dispositivo y salida del grafo
+    static constexpr NodeID audioInputNodeID = 1;
+    static constexpr NodeID audioOutputNodeID = 2;
+
+    // Buffers temporales (de todos los canales del grafo) disponibles por nodo
+    static constexpr int scratchBuffersPerNode = 4;
+
+    // Pico por debajo del cual un bloque se considera silencio (-120 dBFS)
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    // Valores muestra a muestra de un parámetro durante la próxima llamada a process()
+    struct ParameterRamp
+    {
+        ParameterTable::ParameterID parameterID = ParameterTable::invalidParameterID;
+        const float* values = nullptr;
+    };
+
+    AudioGraph();
+    ~AudioGraph() override;
+
+    // Edición del modelo (hilo de mensajes). Cada cambio programa una recompilación.
+    NodeID addNode(std::unique_ptr<AudioGraphNode> newNode);
+    bool removeNode(NodeID nodeID);
+    bool addConnection(NodeID source, NodeID destination);
+    bool removeConnection(NodeID source, NodeID destination);
+    bool canConnect(NodeID source, NodeID destination) const;
+    AudioGraphNode* getNodeForID(NodeID nodeID) const;
+    int getNumNodes() const;
+    void clear();
+
+    int getNumWorkerThreads() const { return threadPool.getNumWorkerThreads(); }
+
+    // Configuración (fuera del hilo de audio, con el callback detenido)
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void releaseResources();
+
+    // Compilar el modelo y publicar la secuencia resultante inmediatamente
+    bool rebuild();
+
+    // Borrar el estado interno de todos los nodos. Sólo cuando ningún hilo
+    // esté dentro de process() (callback detenido o cedido al render offline).
+    void resetNodes();
+
+    // Tabla de la que se reparten los cambios de parámetros a los nodos
+    void setParameterTable(ParameterTable* table) { parameterTable = table; }
+
+    // Latencia total de la salida en la secuencia que está sonando, para que
+    // el transporte y la grabación puedan corregirla
+    int getOutputLatencySamples() const noexcept { return outputLatencySamples.load(std::memory_order_relaxed); }
+
+    // Nodos dormidos por silencio en el último bloque y total de la secuencia
+    int getNumSleepingNodes() const noexcept { return sleepingNodes.load(std::memory_order_relaxed); }
+    int getNumActiveSequenceNodes() const noexcept { return sequenceNodes.load(std::memory_order_relaxed); }
+
+    // Hilo de audio. Las rampas (opcionales) cubren las numSamples muestras y
+    // sólo se reparten a los nodos suscritos a cada parámetro.
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                 const ParameterRamp* ramps = nullptr, int numRamps = 0);
+
+private:
+    struct RenderSequence;
+    class MaintenanceThread;
+
+    void handleAsyncUpdate() override;
+
+    std::unique_ptr<RenderSequence> compileLocked() const;
+    void publish(std::unique_ptr<RenderSequence> sequence);
+    void retireActiveSequence();
+    void dispatchParameterChanges(bool sequenceChanged);
+    void dispatchParameterRamps(const ParameterRamp* ramps, int numRamps, int offset, int numSamples);
+    void reclaimRetiredSequences();
+    void rebuildIfLatencyChanged();
+    bool isNodeOrEndpoint(NodeID nodeID) const;
+    bool dependsOnLocked(NodeID nodeID, NodeID possibleAncestor) const;
+
+    // Modelo del grafo (protegido por modelLock; el callback nunca lo toca)
+    juce::CriticalSection modelLock;
+    std::map<NodeID, std::shared_ptr<AudioGraphNode>> nodes;
+    std::set<std::pair<NodeID, NodeID>> connections;
+    NodeID nextNodeID = audioOutputNodeID + 1;
+
+    double currentSampleRate = 0.0;
+    int maximumBlockSize = 0;
+    int numGraphChannels = 2;
+    bool isPrepared = false;
+
+    ParameterTable* parameterTable = nullptr;
+
+    // Publicación: el hilo de mensajes deja la secuencia en pendingSequence y
+    // el hilo de audio la adopta como activeSequence al inicio de un bloque
+    std::atomic<RenderSequence*> pendingSequence { nullptr };
+    RenderSequence* activeSequence = nullptr; // propiedad exclusiva del hilo de audio
+
+    // Secuencias retiradas por el hilo de audio, pendientes de liberar
+    static constexpr int retiredQueueSize = 32;
+    juce::AbstractFifo retiredFifo { retiredQueueSize };
+    std::array<RenderSequence*, retiredQueueSize> retiredSequences {};
+
+    // Lo marca cualquier nodo que cambie de latencia; lo atiende maintenanceThread
+    std::atomic<bool> latencyChanged { false };
+    std::atomic<int> outputLatencySamples { 0 };
+    std::atomic<int> sleepingNodes { 0 };
+    std::atomic<int> sequenceNodes { 0 };
+
+    // Libera secuencias retiradas y recompila cuando cambian latencias
+    std::unique_ptr<MaintenanceThread> maintenanceThread;
+
+    // Pool de trabajadores de tiempo real para las ramas independientes
+    AudioRenderThreadPool threadPool;
+
+    // Un arena por hilo que ejecuta nodos (índice 0 = hilo de audio)
+    std::vector<std::unique_ptr<AudioScratchArena>> scratchArenas;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioGraph)
+};
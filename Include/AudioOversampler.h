@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/**
+ * @class AudioOversampler
+ * @brief Sobremuestreo 2x/4x/8x con etapas half-band polifásicas en cascada
+ *
+ * Cada etapa dobla la frecuencia con un FIR half-band de fase lineal (ventana
+ * de Kaiser) en forma polifásica: la mitad de los coeficientes son cero y la
+ * rama del centro es un simple retardo, así que sólo se calcula la rama par,
+ * vectorizada sobre muestras consecutivas con AudioSimd. Las etapas de 4x y
+ * 8x trabajan con una banda de transición mucho más ancha y salen cortas.
+ *
+ * La calidad fija la atenuación de la banda eliminada (Quality) y con ella el
+ * número de coeficientes, para elegir por instancia el ajuste más barato que
+ * suene limpio. La latencia de ida y vuelta se redondea a muestras enteras de
+ * la frecuencia base con un retardo de relleno a la frecuencia alta, de modo
+ * que getLatencySamples() es exacta y sirve para la compensación del grafo.
+ *
+ * Toda la memoria se reserva en prepare(); processUp()/processDown() no
+ * reservan nada y son aptas para el hilo de audio.
+ */
+class AudioOversampler
+{
+public:
+    enum class Quality
+    {
+        kDraft,     // ~60 dB en la banda eliminada
+        kStandard,  // ~90 dB
+        kHigh       // ~120 dB
+    };
+
+    static constexpr int maxFactor = 8;
+
+    AudioOversampler() = default;
+
+    // Fuera del hilo de audio. factor 1 desactiva el sobremuestreo.
+    void prepare(int numChannels, int maxBlockSize, int factor, Quality quality);
+    void reset() noexcept;
+
+    int getFactor() const noexcept { return 1 << static_cast<int>(stages.size()); }
+    bool isActive() const noexcept { return !stages.empty(); }
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+    Quality getQuality() const noexcept { return quality; }
+
+    // Latencia de ida y vuelta en muestras de la frecuencia base
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+    // Coste aproximado: productos por muestra base y canal, sumando las dos direcciones
+    int getMultipliesPerSample() const noexcept;
+
+    static float getStopbandAttenuationDb(Quality quality) noexcept;
+
+    /**
+     * Hilo de audio: sube input a getFactor() veces su frecuencia y devuelve
+     * una vista sobre el buffer interno, que el llamador procesa in-place y
+     * luego baja con processDown(). input no puede superar maxBlockSize.
+     */
+    template <typename InputBlock>
+    juce::dsp::AudioBlock<float> processUp(const InputBlock& input) noexcept
+    {
+        const int numSamples = static_cast<int>(input.getNumSamples());
+        const int channels = juce::jmin(static_cast<int>(input.getNumChannels()), numChannels);
+
+        jassert(numSamples <= maxBlockSize);
+        jassert(isActive());
+
+        for (int ch = 0; ch < channels; ++ch)
+            upsampleChannel(ch, input.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+
+        auto& top = stages.back().output;
+        return juce::dsp::AudioBlock<float>(top.getArrayOfWritePointers(), static_cast<size_t>(channels),
+                                            static_cast<size_t>(numSamples * getFactor()));
+    }
+
+    // Hilo de audio: baja el buffer interno a output (mismo tamaño que el processUp anterior)
+    template <typename OutputBlock>
+    void processDown(OutputBlock& output) noexcept
+    {
+        const int numSamples = static_cast<int>(output.getNumSamples());
+        const int channels = juce::jmin(static_cast<int>(output.getNumChannels()), numChannels);
+
+        for (int ch = 0; ch < channels; ++ch)
+            downsampleChannel(ch, output.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+    }
+
+private:
+    struct Stage
+    {
+        std::vector<float> coefficients;        // primera mitad de la rama par (simétrica)
+        int halfLength = 0;                     // K: la half-band completa tiene 4K - 1 coeficientes
+
+        juce::AudioBuffer<float> upHistory;     // entrada de la subida, con 2K - 1 muestras previas
+        juce::AudioBuffer<float> upFiltered;    // rama par de la subida
+        juce::AudioBuffer<float> downEven;      // muestras pares de la bajada, con 2K - 1 previas
+        juce::AudioBuffer<float> downOdd;       // muestras impares de la bajada, con K previas
+        juce::AudioBuffer<float> output;        // salida de la subida, a la frecuencia de la etapa
+    };
+
+    void upsampleChannel(int channel, const float* input, int numSamples) noexcept;
+    void downsampleChannel(int channel, float* output, int numSamples) noexcept;
+
+    static void designStage(Stage& stage, double transitionWidth, double attenuationDb);
+
+    // y[j] = sum_m c[m] * x[j - m], con la simetría c[m] == c[2K - 1 - m]; x apunta tras 2K - 1 muestras previas
+    static void filterEvenBranch(const float* x, float* y, int numSamples, const float* coefficients, int halfLength) noexcept;
+
+    std::vector<Stage> stages;
+    Quality quality = Quality::kStandard;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+    int latencySamples = 0;
+
+    // Retardo de relleno a la frecuencia más alta para que la latencia sea entera
+    int padSamples = 0;
+    juce::AudioBuffer<float> padHistory;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioOversampler)
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AudioFastMath.h"
+#include "AudioSimd.h"
+#include <cmath>
+
+/**
+ * @class AudioParameterSmoother
+ * @brief Rampa sin clics de un parámetro hacia su objetivo, por tramas SIMD
+ *
+ * El setter del procesador sólo guarda el objetivo. El hilo de audio ve el
+ * cambio al pedir la siguiente trama y calcula entonces, una sola vez, el
+ * paso de la rampa desde el valor actual; mientras el objetivo no cambia no se
+ * recalcula nada y un parámetro quieto cuesta un broadcast por trama.
+ *
+ * Cada valor de la rampa es una función cerrada de su posición (inicio + paso
+ * * n, sin acumular), así que nextFrame() por lanes y nextSample() muestra a
+ * muestra dan los mismos bits. La curva multiplicativa es lineal en log2 y se
+ * evalúa con AudioFastMath::exp2, sin std::exp por muestra; sirve para
+ * ganancias, drive y cualquier valor estrictamente positivo.
+ */
+class AudioParameterSmoother
+{
+public:
+    enum class Curve
+    {
+        kLinear,
+        kMultiplicative     // sólo valores > 0
+    };
+
+    static constexpr double defaultRampSeconds = 0.02;
+
+    explicit AudioParameterSmoother(float initialValue = 0.0f, Curve curveToUse = Curve::kLinear) noexcept
+        : curve(curveToUse)
+    {
+        setCurrentAndTargetValue(initialValue);
+    }
+
+    // Fuera del hilo de audio (prepare() del procesador): fija la longitud de
+    // la rampa para esta frecuencia y salta al objetivo
+    void prepare(double sampleRate, double rampSeconds = defaultRampSeconds) noexcept
+    {
+        rampLength = juce::jmax(1, static_cast<int>(std::lround(sampleRate * rampSeconds)));
+        setCurrentAndTargetValue(target);
+    }
+
+    // Sólo guarda el objetivo; la rampa se calcula en el hilo de audio
+    void setTargetValue(float newTarget) noexcept
+    {
+        jassert(curve == Curve::kLinear || newTarget > 0.0f);
+        target = newTarget;
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        jassert(curve == Curve::kLinear || newValue > 0.0f);
+        target = rampTarget = currentValue = newValue;
+        rampPosition = rampLength;
+    }
+
+    float getTargetValue() const noexcept { return target; }
+    float getCurrentValue() const noexcept { return currentValue; }
+    bool isSmoothing() const noexcept { return rampPosition < rampLength || target != rampTarget; }
+
+    // Hilo de audio: los Vec::width valores siguientes; avanza numValid muestras
+    AudioSimd::Vec nextFrame(int numValid) noexcept
+    {
+        using AudioSimd::Vec;
+
+        startRampIfTargetChanged();
+
+        if (rampPosition >= rampLength)
+            return Vec(currentValue);
+
+        alignas(32) static constexpr float laneOffsets[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+        static_assert(Vec::width <= 8, "laneOffsets cubre hasta 8 lanes");
+
+        const auto positions = Vec(static_cast<float>(rampPosition)) + Vec::load(laneOffsets);
+        const auto values = AudioSimd::select(positions < Vec(static_cast<float>(rampLength)),
+                                              valueAt(positions), Vec(rampTarget));
+
+        advance(numValid);
+        return values;
+    }
+
+    // Hilo de audio: el siguiente valor, igual que la lane correspondiente de nextFrame()
+    float nextSample() noexcept
+    {
+        startRampIfTargetChanged();
+
+        if (rampPosition >= rampLength)
+            return currentValue;
+
+        advance(1);
+        return currentValue;
+    }
+
+private:
+    // Valor a n muestras del inicio de la rampa, con T float o Vec
+    template <typename T>
+    T valueAt(T position) const noexcept
+    {
+        const auto value = T(rampStart) + T(rampStep) * position;
+
+        if (curve == Curve::kMultiplicative)
+            return AudioFastMath::exp2(value);
+
+        return value;
+    }
+
+    float toRampDomain(float value) const noexcept
+    {
+        return curve == Curve::kMultiplicative ? std::log2(juce::jmax(value, 1.0e-30f)) : value;
+    }
+
+    void startRampIfTargetChanged() noexcept
+    {
+        if (target == rampTarget)
+            return;
+
+        rampTarget = target;
+        rampStart = toRampDomain(currentValue);
+        rampStep = (toRampDomain(rampTarget) - rampStart) / static_cast<float>(rampLength);
+        rampPosition = 0;
+    }
+
+    void advance(int numSamples) noexcept
+    {
+        rampPosition += numSamples;
+
+        if (rampPosition >= rampLength)
+        {
+            rampPosition = rampLength;
+            currentValue = rampTarget;
+        }
+        else
+        {
+            currentValue = valueAt(static_cast<float>(rampPosition));
+        }
+    }
+
+    Curve curve;
+    float target = 0.0f;            // lo último que pidió el setter
+    float rampTarget = 0.0f;        // objetivo de la rampa en curso
+    float currentValue = 0.0f;
+    float rampStart = 0.0f;         // en log2 para la curva multiplicativa
+    float rampStep = 0.0f;
+    int rampPosition = 0;
+    int rampLength = static_cast<int>(44100.0 * defaultRampSeconds);
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include "AudioProcessors.h"
+#include <array>
+#include <tuple>
+#include <utility>
+
+/**
+ * @class AudioProcessorChain
+ * @brief Cadena de procesadores de AudioProcessors.h fusionada en tiempo de compilación
+ *
+ * Los tipos de las etapas se fijan en la plantilla, así que no hay despacho
+ * virtual ni buffers intermedios: cada trama de Vec::width muestras se carga
+ * una vez, pasa por los kernels de todas las etapas activas en registros y se
+ * guarda una vez. El bypass de cada etapa es un bit de una máscara; process()
+ * elige la instanciación ya compilada para esa máscara, de modo que una etapa
+ * en bypass no cuesta nada. El resultado es idéntico bit a bit al de llamar a
+ * process() de cada etapa en orden.
+ *
+ * Lo que se ahorra son las pasadas por memoria, así que la ganancia es mayor
+ * cuanto más ligeras son las etapas (clippers, ganancias, mezclas). Con varias
+ * etapas aritméticamente pesadas seguidas la trama fusionada agota los
+ * registros y puede no compensar frente a process() por separado.
+ *
+ * Uso:
+ *   AudioProcessorChain<AudioCompressor, AudioDistortion, AudioBitCrusher> chain;
+ *   chain.get<1>().setDrive(12.0f);
+ *   chain.setBypassed<2>(true);
+ *   chain.process(context);
+ */
+template <typename... Processors>
+class AudioProcessorChain
+{
+public:
+    static constexpr size_t numStages = sizeof...(Processors);
+
+    // 2^numStages instanciaciones de processFused; más allá de 6 etapas mejor partir la cadena
+    static_assert(numStages > 0 && numStages <= 6, "AudioProcessorChain admite entre 1 y 6 etapas");
+
+    AudioProcessorChain() = default;
+    ~AudioProcessorChain() = default;
+
+    template <size_t Index>
+    auto& get() noexcept { return std::get<Index>(processors); }
+
+    template <size_t Index>
+    const auto& get() const noexcept { return std::get<Index>(processors); }
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        std::apply([&spec](auto&... stage) { (stage.prepare(spec), ...); }, processors);
+    }
+
+    void reset()
+    {
+        std::apply([](auto&... stage) { (stage.reset(), ...); }, processors);
+    }
+
+    template <size_t Index>
+    void setBypassed(bool shouldBeBypassed) noexcept
+    {
+        static_assert(Index < numStages, "Etapa fuera de la cadena");
+
+        if (shouldBeBypassed)
+            bypassMask |= (1u << Index);
+        else
+            bypassMask &= ~(1u << Index);
+    }
+
+    template <size_t Index>
+    bool isBypassed() const noexcept
+    {
+        static_assert(Index < numStages, "Etapa fuera de la cadena");
+        return (bypassMask & (1u << Index)) != 0;
+    }
+
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        dispatch<ProcessContext>(context, std::make_index_sequence<1u << numStages>());
+    }
+
+    // Versión con la máscara de bypass fija en tiempo de compilación
+    template <unsigned bypassed, typename ProcessContext>
+    void processFused(const ProcessContext& context) noexcept
+    {
+        processStages<bypassed, 0>(context);
+    }
+
+private:
+    // Recoge la función de trama de cada etapa activa (anidando withFrameKernel,
+    // que puede elegir una variante especializada) y las ejecuta todas sobre
+    // la misma trama. Las etapas en bypass no llegan a construir su kernel.
+    template <unsigned bypassed, size_t Index, typename ProcessContext, typename... Kernels>
+    void processStages(const ProcessContext& context, Kernels&... kernels) noexcept
+    {
+        if constexpr (Index == numStages && sizeof...(Kernels) == 0)
+        {
+            // Toda la cadena en bypass
+            if (context.usesSeparateInputAndOutputBlocks())
+                context.getOutputBlock().copyFrom(context.getInputBlock());
+        }
+        else if constexpr (Index == numStages)
+        {
+            processContextInFrames(context, [&kernels...](AudioSimd::Vec* frame, int numChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+            {
+                (kernels(frame, numChannels, numValid), ...);
+            });
+        }
+        else if constexpr ((bypassed & (1u << Index)) != 0)
+        {
+            processStages<bypassed, Index + 1>(context, kernels...);
+        }
+        else
+        {
+            std::get<Index>(processors).withFrameKernel([&](auto& kernel)
+            {
+                processStages<bypassed, Index + 1>(context, kernels..., kernel);
+            });
+        }
+    }
+
+    template <typename ProcessContext, size_t... Mask>
+    void dispatch(const ProcessContext& context, std::index_sequence<Mask...>) noexcept
+    {
+        using FusedFunction = void (AudioProcessorChain::*)(const ProcessContext&);
+        static constexpr std::array<FusedFunction, sizeof...(Mask)> table {
+            &AudioProcessorChain::processFused<static_cast<unsigned>(Mask), ProcessContext>...
+        };
+
+        (this->*table[bypassMask])(context);
+    }
+
+    std::tuple<Processors...> processors;
+    unsigned bypassMask = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioProcessorChain)
+};
@@ -1,6 +1,579 @@
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "AudioFastMath.h"
+#include "AudioOversampler.h"
+#include "AudioParameterSmoother.h"
+#include "AudioSimd.h"
+#include <array>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+// Proceso por bloques: todos los procesadores trabajan por tramas de
+// Vec::width muestras de todos los canales. withFrameKernel() entrega, una
+// vez por bloque, una función de trama con los parámetros ya cargados en
+// vectores; es también la unidad que fusiona AudioProcessorChain.
+//==============================================================================
+static constexpr int maxFrameChannels = 16;
+
+// Recorre el bloque por tramas. Con fixedChannels > 0 el número de canales es
+// constante en compilación y la trama entera vive en registros, también a
+// través de todas las etapas de una cadena fusionada.
+template <int fixedChannels, typename ProcessContext, typename FrameKernel>
+void processFramesWithChannels(const ProcessContext& context, int numChannels, FrameKernel& processFrame) noexcept
+{
+    using AudioSimd::Vec;
+    
+    const auto& inputBlock = context.getInputBlock();
+    auto& outputBlock = context.getOutputBlock();
+    const auto numSamples = static_cast<int>(outputBlock.getNumSamples());
+    const int frameChannels = fixedChannels > 0 ? fixedChannels : numChannels;
+    
+    Vec frame[fixedChannels > 0 ? fixedChannels : maxFrameChannels];
+    
+    for (int i = 0; i < numSamples; i += Vec::width)
+    {
+        const int numValid = juce::jmin(Vec::width, numSamples - i);
+        
+        for (int ch = 0; ch < frameChannels; ++ch)
+            frame[ch] = Vec::load(inputBlock.getChannelPointer(static_cast<size_t>(ch)) + i, numValid);
+        
+        processFrame(frame, frameChannels, numValid);
+        
+        for (int ch = 0; ch < frameChannels; ++ch)
+            frame[ch].store(outputBlock.getChannelPointer(static_cast<size_t>(ch)) + i, numValid);
+    }
+}
+
+template <typename ProcessContext, typename FrameKernel>
+void processContextInFrames(const ProcessContext& context, FrameKernel&& processFrame) noexcept
+{
+    const auto& inputBlock = context.getInputBlock();
+    auto& outputBlock = context.getOutputBlock();
+    const auto numChannels = static_cast<int>(outputBlock.getNumChannels());
+    
+    jassert(static_cast<int>(inputBlock.getNumChannels()) == numChannels);
+    jassert(inputBlock.getNumSamples() == outputBlock.getNumSamples());
+    jassert(numChannels <= maxFrameChannels);
+    
+    if (context.isBypassed)
+    {
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+        
+        return;
+    }
+    
+    // Mono y estéreo, los casos habituales, con el número de canales fijo
+    switch (numChannels)
+    {
+        case 1:  processFramesWithChannels<1>(context, 1, processFrame); break;
+        case 2:  processFramesWithChannels<2>(context, 2, processFrame); break;
+        default: processFramesWithChannels<0>(context, juce::jmin(numChannels, maxFrameChannels), processFrame); break;
+    }
+}
+
+// Sube el bloque con oversampler, llama a processUpBlock con un contexto
+// in-place a la frecuencia alta y lo baja a la salida, en trozos del tamaño
+// para el que se preparó el oversampler
+template <typename ProcessContext, typename ProcessUpBlock>
+void processContextOversampled(const ProcessContext& context, AudioOversampler& oversampler, ProcessUpBlock&& processUpBlock) noexcept
+{
+    const auto& inputBlock = context.getInputBlock();
+    auto& outputBlock = context.getOutputBlock();
+    
+    if (context.isBypassed)
+    {
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+        
+        return;
+    }
+    
+    const auto numSamples = outputBlock.getNumSamples();
+    const auto maxChunk = static_cast<size_t>(oversampler.getMaxBlockSize());
+    
+    for (size_t offset = 0; offset < numSamples; offset += maxChunk)
+    {
+        const auto chunk = juce::jmin(maxChunk, numSamples - offset);
+        auto outputChunk = outputBlock.getSubBlock(offset, chunk);
+        
+        auto upBlock = oversampler.processUp(inputBlock.getSubBlock(offset, chunk));
+        juce::dsp::ProcessContextReplacing<float> upContext(upBlock);
+        processUpBlock(upContext);
+        oversampler.processDown(outputChunk);
+    }
+}
+
+//==============================================================================
+// AudioLevelDetector - Detector de envolvente multicanal para la dinámica
+//==============================================================================
+/**
+ * Detector de AudioCompressor y AudioExpander. El estado de cada canal
+ * (envolvente y paso alto) vive en arrays, uno por magnitud, y en cada muestra
+ * los canales ocupan las lanes de un Vec: la recursión en el tiempo de hasta
+ * Vec::width canales cuesta lo mismo que la de uno, y un stem de 5.1 pasa por
+ * una sola instancia.
+ *
+ * El enlace decide qué sigue cada envolvente: su propio canal (kIndependent),
+ * el máximo de todos (kMaximum, el estéreo de siempre) o la media (kAverage).
+ * La entrada es la propia señal o un bus de sidechain, y el paso alto opcional
+ * (Butterworth de segundo orden) quita graves al detector para que el bombo
+ * no mueva toda la mezcla.
+ *
+ * El nivel es el pico (kPeak) o el valor eficaz en una ventana deslizante
+ * (kRms). La ventana es una suma de cuadrados sobre un anillo: cada muestra
+ * suma la nueva y resta la que sale, así que cuesta lo mismo con 1 ms que
+ * con 200. Para que el error de redondeo no se acumule, en paralelo se suma
+ * desde cero lo que entra y, cada vez que el anillo da la vuelta, esa suma
+ * (que ya cubre la ventana entera) sustituye a la acumulada. La envolvente
+ * de ataque y liberación sigue al nivel en dB igual en los dos modos.
+ */
+class AudioLevelDetector
+{
+public:
+    enum class Link
+    {
+        kIndependent,
+        kMaximum,
+        kAverage
+    };
+    
+    enum class Mode
+    {
+        kPeak,
+        kRms
+    };
+    
+    static constexpr float maxRmsWindowMs = 200.0f;
+    
+    // Bus externo para el detector: un puntero por canal que avanza con cada
+    // trama. Un bus con menos canales se reparte en ciclo (uno mono va a todos).
+    struct Sidechain
+    {
+        std::array<const float*, maxFrameChannels> channels {};
+        int numChannels = 0;
+        
+        template <typename Block>
+        static Sidechain fromBlock(const Block& block) noexcept
+        {
+            Sidechain sidechain;
+            sidechain.numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), maxFrameChannels);
+            
+            for (int ch = 0; ch < sidechain.numChannels; ++ch)
+                sidechain.channels[static_cast<size_t>(ch)] = block.getChannelPointer(static_cast<size_t>(ch));
+            
+            return sidechain;
+        }
+        
+        bool isActive() const noexcept { return numChannels > 0; }
+        
+        AudioSimd::Vec load(int channel, int numValid) const noexcept
+        {
+            return AudioSimd::Vec::load(channels[static_cast<size_t>(channel % numChannels)], numValid);
+        }
+        
+        void advance(int numSamples) noexcept
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[static_cast<size_t>(ch)] += numSamples;
+        }
+    };
+    
+    AudioLevelDetector() noexcept
+    {
+        setTimes(5.0f, 50.0f);
+    }
+    
+    // numRmsChannels: canales para los que se reserva la ventana RMS (hasta
+    // maxRmsWindowMs); con 0 el detector sólo puede trabajar en pico
+    void prepare(double newSampleRate, int numRmsChannels = 0)
+    {
+        sampleRate = static_cast<float>(newSampleRate);
+        updateEnvelopeCoefficients();
+        updateHighPassCoefficients();
+        
+        constexpr int width = AudioSimd::Vec::width;
+        rmsChannels = juce::jlimit(0, maxFrameChannels, numRmsChannels);
+        rmsStride = (rmsChannels + width - 1) / width * width;
+        rmsCapacity = rmsChannels > 0 ? static_cast<int>(std::ceil(maxRmsWindowMs * 0.001f * sampleRate)) : 0;
+        rmsRing.assign(static_cast<size_t>(rmsCapacity * rmsStride), 0.0f);
+        setRmsWindow(rmsWindowMs);
+        reset();
+    }
+    
+    void reset() noexcept
+    {
+        envelopes.fill(0.0f);
+        highPassState1.fill(0.0f);
+        highPassState2.fill(0.0f);
+        restartRms();
+    }
+    
+    // kRms necesita prepare() con numRmsChannels > 0; si no, sigue en pico
+    void setMode(Mode newMode) noexcept { mode = newMode; }
+    Mode getMode() const noexcept { return mode; }
+    
+    // Ventana del valor eficaz; al cambiarla el promedio vuelve a empezar
+    void setRmsWindow(float windowMs) noexcept
+    {
+        rmsWindowMs = juce::jlimit(1.0f, maxRmsWindowMs, windowMs);
+        requestedRmsLength = juce::jlimit(1, juce::jmax(1, rmsCapacity),
+                                          static_cast<int>(std::round(rmsWindowMs * 0.001f * sampleRate)));
+    }
+    
+    // Los coeficientes sólo se recalculan aquí y en prepare()
+    void setTimes(float attackMs, float releaseMs) noexcept
+    {
+        attacks.fill(attackMs);
+        releases.fill(releaseMs);
+        updateEnvelopeCoefficients();
+    }
+    
+    // Tiempos de la envolvente de un canal (sólo cuenta con kIndependent)
+    void setChannelTimes(int channel, float attackMs, float releaseMs) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, maxFrameChannels));
+        attacks[static_cast<size_t>(channel)] = attackMs;
+        releases[static_cast<size_t>(channel)] = releaseMs;
+        updateEnvelopeCoefficients();
+    }
+    
+    // 0 desactiva el paso alto
+    void setHighPass(float frequencyHz) noexcept
+    {
+        highPassFrequency = juce::jmax(0.0f, frequencyHz);
+        updateHighPassCoefficients();
+    }
+    
+    void setLink(Link newLink) noexcept { link = newLink; }
+    Link getLink() const noexcept { return link; }
+    
+    // Reducción (dB) del canal 0 en la última muestra procesada, para medidores
+    float getLastReduction() const noexcept { return lastReduction; }
+    
+    /**
+     * Una trama: input[ch] es la señal del detector de cada canal y gains[ch]
+     * recibe la ganancia lineal que hay que aplicarle. computeReduction(envelope, i, offset)
+     * devuelve la reducción en dB (>= 0) de las lanes de los canales offset..
+     * offset + Vec::width - 1 en la muestra i, y se aplica como
+     * -reduction * reductionScale dB. Sólo las numValid
+     * primeras muestras avanzan el estado.
+     */
+    template <typename ComputeReduction>
+    void processFrame(const AudioSimd::Vec* input, AudioSimd::Vec* gains, int numChannels, int numValid,
+                      bool fast, float reductionScale, ComputeReduction&& computeReduction) noexcept
+    {
+        using AudioSimd::Vec;
+        constexpr int width = Vec::width;
+        
+        const int inputGroups = (numChannels + width - 1) / width;
+        const int envelopeChannels = link == Link::kIndependent ? numChannels : 1;
+        const int envelopeGroups = (envelopeChannels + width - 1) / width;
+        const float neutral = fast ? 0.0f : 1.0f;
+        const bool rms = isRmsActive(numChannels);
+        
+        if (rms && rmsLength != requestedRmsLength)
+            restartRms();
+        
+        // Traspuesta: una fila por muestra con los canales en columnas. Cada
+        // fila pasa de señal a nivel y de nivel a ganancia in-place.
+        alignas(32) float rows[width][maxFrameChannels];
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            alignas(32) float lanes[width];
+            input[ch].store(lanes);
+            
+            for (int i = 0; i < width; ++i)
+                rows[i][ch] = lanes[i];
+        }
+        
+        for (int ch = numChannels; ch < inputGroups * width; ++ch)
+            for (int i = 0; i < width; ++i)
+                rows[i][ch] = 0.0f;
+        
+        for (int i = 0; i < numValid; ++i)
+        {
+            float* row = rows[i];
+            
+            for (int offset = 0; offset < inputGroups * width; offset += width)
+            {
+                auto x = Vec::load(row + offset);
+                
+                if (highPassEnabled)
+                    x = highPass(x, offset);
+                
+                if (rms)
+                    pushRmsSquares(x * x, offset).store(row + offset);
+                else
+                    AudioSimd::abs(x).store(row + offset);
+            }
+            
+            if (rms)
+                advanceRms(0, inputGroups * width);
+            
+            // Con enlace todo el detector queda en la columna 0
+            if (link == Link::kMaximum)
+            {
+                for (int ch = 1; ch < numChannels; ++ch)
+                    row[0] = AudioSimd::max(row[0], row[ch]);
+            }
+            else if (link == Link::kAverage)
+            {
+                float sum = row[0];
+                
+                for (int ch = 1; ch < numChannels; ++ch)
+                    sum += row[ch];
+                
+                row[0] = sum / static_cast<float>(numChannels);
+            }
+            
+            for (int offset = 0; offset < envelopeGroups * width; offset += width)
+            {
+                const auto levelDb = rms ? toDecibels(Vec::load(row + offset) + Vec(rmsFloor), fast, rmsFloorDb) * Vec(0.5f)
+                                         : toDecibels(Vec::load(row + offset) + Vec(peakFloor), fast);
+                
+                auto envelope = Vec::load(envelopes.data() + offset);
+                envelope = envelope + (levelDb - envelope) * AudioSimd::select(levelDb > envelope, Vec::load(alphaAttack.data() + offset),
+                                                                                                   Vec::load(alphaRelease.data() + offset));
+                envelope.store(envelopes.data() + offset);
+                
+                const auto reduction = computeReduction(envelope, i, offset);
+                const auto gainDb = -reduction * Vec(reductionScale);
+                
+                alignas(32) float reductionLanes[width];
+                reduction.store(reductionLanes);
+                gainDb.store(row + offset);
+                
+                if (offset == 0 && i == numValid - 1)
+                    lastReduction = reductionLanes[0];
+                
+                // Sin reducción la ganancia es 1 sin calcular nada
+                if (!fast)
+                    for (int lane = 0; lane < width; ++lane)
+                        row[offset + lane] = reductionLanes[lane] > 0.0f ? juce::Decibels::decibelsToGain(row[offset + lane]) : 1.0f;
+            }
+        }
+        
+        // De vuelta a una trama por canal
+        for (int column = 0; column < envelopeChannels; ++column)
+        {
+            alignas(32) float lanes[width];
+            
+            for (int i = 0; i < width; ++i)
+                lanes[i] = i < numValid ? rows[i][column] : neutral;
+            
+            gains[column] = fast ? AudioFastMath::decibelsToGain(Vec::load(lanes)) : Vec::load(lanes);
+        }
+        
+        for (int ch = envelopeChannels; ch < numChannels; ++ch)
+            gains[ch] = gains[0];
+    }
+    
+    // Muestra a muestra: los canales llegan de uno en uno y no hay enlace real;
+    // en los modos enlazados todos comparten la envolvente del canal 0
+    float processSample(float input, int channel, bool fast) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, maxFrameChannels));
+        channel = juce::jlimit(0, maxFrameChannels - 1, channel);
+        
+        const auto x = highPassEnabled ? highPassSample(input, channel) : input;
+        float levelDb;
+        
+        if (isRmsActive(channel + 1))
+        {
+            if (rmsLength != requestedRmsLength)
+                restartRms();
+            
+            const auto meanSquare = pushRmsSquare(x * x, channel);
+            advanceRms(channel, 1);
+            levelDb = 0.5f * toDecibels(meanSquare + rmsFloor, fast, rmsFloorDb);
+        }
+        else
+        {
+            levelDb = toDecibels(std::abs(x) + peakFloor, fast);
+        }
+        
+        const auto index = static_cast<size_t>(link == Link::kIndependent ? channel : 0);
+        auto& envelope = envelopes[index];
+        envelope += (levelDb - envelope) * (levelDb > envelope ? alphaAttack[index] : alphaRelease[index]);
+        return envelope;
+    }
+
+private:
+    // Suelo del nivel: -100 dB en pico y en valor eficaz. La media de
+    // cuadrados se convierte con suelo de -200 dB antes de dividir entre dos.
+    static constexpr float peakFloor = 0.00001f;
+    static constexpr float rmsFloor = peakFloor * peakFloor;
+    static constexpr float rmsFloorDb = -200.0f;
+    
+    static AudioSimd::Vec toDecibels(AudioSimd::Vec level, bool fast, float minusInfinityDb = -100.0f) noexcept
+    {
+        return fast ? AudioFastMath::gainToDecibels(level, minusInfinityDb)
+                    : level.map([minusInfinityDb](float value) { return juce::Decibels::gainToDecibels(value, minusInfinityDb); });
+    }
+    
+    static float toDecibels(float level, bool fast, float minusInfinityDb = -100.0f) noexcept
+    {
+        return fast ? AudioFastMath::gainToDecibels(level, minusInfinityDb) : juce::Decibels::gainToDecibels(level, minusInfinityDb);
+    }
+    
+    bool isRmsActive(int numChannels) const noexcept
+    {
+        jassert(mode != Mode::kRms || numChannels <= rmsChannels);    // prepare() con menos canales RMS
+        return mode == Mode::kRms && numChannels <= rmsChannels;
+    }
+    
+    void restartRms() noexcept
+    {
+        rmsLength = requestedRmsLength;
+        std::fill(rmsRing.begin(), rmsRing.end(), 0.0f);
+        rmsPositions.fill(0);
+        rmsSums.fill(0.0f);
+        rmsFreshSums.fill(0.0f);
+    }
+    
+    // Cuadrados de una muestra de los canales offset.. offset + Vec::width - 1
+    // en sus ranuras del anillo; devuelve la media de la ventana. Todos los
+    // canales de process() comparten posición (la del canal 0).
+    AudioSimd::Vec pushRmsSquares(AudioSimd::Vec squares, int offset) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        auto* slot = rmsRing.data() + static_cast<size_t>(rmsPositions[0] * rmsStride + offset);
+        const auto oldest = Vec::load(slot);
+        squares.store(slot);
+        
+        const auto sum = Vec::load(rmsSums.data() + offset) + squares - oldest;
+        sum.store(rmsSums.data() + offset);
+        (Vec::load(rmsFreshSums.data() + offset) + squares).store(rmsFreshSums.data() + offset);
+        
+        return AudioSimd::max(sum, Vec(0.0f)) * Vec(1.0f / static_cast<float>(rmsLength));
+    }
+    
+    // Lo mismo para un canal suelto (processSample), con su propia posición
+    float pushRmsSquare(float square, int channel) noexcept
+    {
+        const auto index = static_cast<size_t>(channel);
+        auto& slot = rmsRing[static_cast<size_t>(rmsPositions[index] * rmsStride + channel)];
+        
+        rmsSums[index] = rmsSums[index] + square - slot;
+        rmsFreshSums[index] += square;
+        slot = square;
+        
+        return AudioSimd::max(rmsSums[index], 0.0f) * (1.0f / static_cast<float>(rmsLength));
+    }
+    
+    // Avanza la posición de los canales first.. first + count - 1; al dar la
+    // vuelta la suma desde cero sustituye a la acumulada
+    void advanceRms(int first, int count) noexcept
+    {
+        const auto index = static_cast<size_t>(first);
+        auto position = rmsPositions[index] + 1;
+        
+        if (position == rmsLength)
+        {
+            position = 0;
+            
+            for (int ch = first; ch < first + count; ++ch)
+            {
+                rmsSums[static_cast<size_t>(ch)] = rmsFreshSums[static_cast<size_t>(ch)];
+                rmsFreshSums[static_cast<size_t>(ch)] = 0.0f;
+            }
+        }
+        
+        std::fill(rmsPositions.begin() + first, rmsPositions.begin() + first + count, position);
+    }
+    
+    void updateEnvelopeCoefficients() noexcept
+    {
+        for (size_t ch = 0; ch < alphaAttack.size(); ++ch)
+        {
+            alphaAttack[ch] = 1.0f - std::exp(-1.0f / (attacks[ch] * 0.001f * sampleRate));
+            alphaRelease[ch] = 1.0f - std::exp(-1.0f / (releases[ch] * 0.001f * sampleRate));
+        }
+    }
+    
+    void updateHighPassCoefficients() noexcept
+    {
+        highPassEnabled = highPassFrequency > 0.0f && highPassFrequency < 0.45f * sampleRate;
+        
+        if (!highPassEnabled)
+            return;
+        
+        // RBJ, Q = 1/sqrt(2)
+        const double omega = juce::MathConstants<double>::twoPi * highPassFrequency / sampleRate;
+        const double cosOmega = std::cos(omega);
+        const double alpha = std::sin(omega) / std::sqrt(2.0);
+        const double a0 = 1.0 + alpha;
+        
+        highPassB0 = static_cast<float>((1.0 + cosOmega) * 0.5 / a0);
+        highPassB1 = static_cast<float>(-(1.0 + cosOmega) / a0);
+        highPassA1 = static_cast<float>(-2.0 * cosOmega / a0);
+        highPassA2 = static_cast<float>((1.0 - alpha) / a0);
+    }
+    
+    // Forma directa transpuesta II; b2 == b0
+    AudioSimd::Vec highPass(AudioSimd::Vec x, int offset) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        const auto state1 = Vec::load(highPassState1.data() + offset);
+        const auto state2 = Vec::load(highPassState2.data() + offset);
+        const auto y = Vec(highPassB0) * x + state1;
+        
+        (Vec(highPassB1) * x - Vec(highPassA1) * y + state2).store(highPassState1.data() + offset);
+        (Vec(highPassB0) * x - Vec(highPassA2) * y).store(highPassState2.data() + offset);
+        return y;
+    }
+    
+    float highPassSample(float x, int channel) noexcept
+    {
+        auto& state1 = highPassState1[static_cast<size_t>(channel)];
+        auto& state2 = highPassState2[static_cast<size_t>(channel)];
+        const auto y = highPassB0 * x + state1;
+        
+        state1 = highPassB1 * x - highPassA1 * y + state2;
+        state2 = highPassB0 * x - highPassA2 * y;
+        return y;
+    }
+    
+    float sampleRate = 44100.0f;
+    Link link = Link::kMaximum;
+    Mode mode = Mode::kPeak;
+    
+    float highPassFrequency = 0.0f;
+    bool highPassEnabled = false;
+    float highPassB0 = 1.0f;
+    float highPassB1 = 0.0f;
+    float highPassA1 = 0.0f;
+    float highPassA2 = 0.0f;
+    
+    // Estructura de arrays: un valor por canal, en grupos de Vec::width
+    alignas(32) std::array<float, maxFrameChannels> envelopes {};
+    alignas(32) std::array<float, maxFrameChannels> alphaAttack {};
+    alignas(32) std::array<float, maxFrameChannels> alphaRelease {};
+    alignas(32) std::array<float, maxFrameChannels> highPassState1 {};
+    alignas(32) std::array<float, maxFrameChannels> highPassState2 {};
+    std::array<float, maxFrameChannels> attacks {};     // ms
+    std::array<float, maxFrameChannels> releases {};    // ms
+    float lastReduction = 0.0f;
+    
+    // Ventana RMS: anillo [posición][canal] con rmsStride columnas
+    std::vector<float> rmsRing;
+    int rmsChannels = 0;
+    int rmsStride = 0;
+    int rmsCapacity = 0;
+    int rmsLength = 1;
+    int requestedRmsLength = 1;
+    float rmsWindowMs = 10.0f;
+    alignas(32) std::array<float, maxFrameChannels> rmsSums {};
+    alignas(32) std::array<float, maxFrameChannels> rmsFreshSums {};
+    std::array<int, maxFrameChannels> rmsPositions {};
+};
 
 //==============================================================================
 // AudioCompressor - Compresor profesional con tipos VCA y Opto
@@ -8,413 +581,3053 @@
 class AudioCompressor
 {
 public:
-    enum class CompressorType
-    {
-        kVCA,
-        kOpto
-    };
+    enum class CompressorType
+    {
+        kVCA,
+        kOpto
+    };
+    
+    AudioCompressor() = default;
+    ~AudioCompressor() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        
+        for (auto* parameter : { &threshold, &slope, &inputGain, &outputGain, &mix })
+            parameter->prepare(spec.sampleRate);
+        
+        detector.setTimes(attack, release);
+        detector.prepare(spec.sampleRate, static_cast<int>(spec.numChannels));
+        reset();
+    }
+    
+    void reset()
+    {
+        detector.reset();
+    }
+    
+    // Los parámetros avanzan una vez por muestra, en la llamada del canal 0
+    template <typename SampleType>
+    SampleType processSample(SampleType input, int channel)
+    {
+        auto next = [channel](AudioParameterSmoother& parameter) { return channel == 0 ? parameter.nextSample() : parameter.getCurrentValue(); };
+        const auto currentInputGain = next(inputGain);
+        const auto currentThreshold = next(threshold);
+        const auto currentSlope = next(slope);
+        const auto currentOutputGain = next(outputGain);
+        const auto currentMix = next(mix);
+        
+        // Aplicar gain de entrada
+        auto sample = input * currentInputGain;
+        
+        // Detector de envolvente (sin sidechain muestra a muestra)
+        const auto envelope = detector.processSample(static_cast<float>(sample), channel, fastMath);
+        
+        // Calcular reducción de ganancia
+        const SampleType gainReduction = computeGainReduction(envelope, currentThreshold, currentSlope, knee);
+        
+        // Convertir a ganancia lineal
+        SampleType gainLinear;
+        
+        if (fastMath)
+        {
+            // En dominio log2 el exponente opto es un simple factor
+            const float typeScale = compressorType == CompressorType::kOpto ? 0.8f : 1.0f;
+            gainLinear = AudioFastMath::decibelsToGain(static_cast<float>(-gainReduction) * typeScale);
+        }
+        else
+        {
+            gainLinear = juce::Decibels::decibelsToGain(-gainReduction);
+            
+            // Aplicar tipo de compresor
+            if (compressorType == CompressorType::kOpto)
+            {
+                // Opto es más suave y lento
+                gainLinear = std::pow(gainLinear, 0.8f);
+            }
+        }
+        
+        // Aplicar compresión
+        auto compressed = sample * gainLinear;
+        
+        // Gain de salida
+        compressed *= currentOutputGain;
+        
+        // Mix (wet/dry)
+        auto output = input + (compressed - input) * currentMix;
+        
+        // Almacenar reducción para metering
+        if (channel == 0)
+            currentGainReduction = gainReduction;
+        
+        return output;
+    }
+    
+    /**
+     * Proceso por bloques. El enlace del detector se elige con
+     * setDetectorLink() (máximo de todos los canales por defecto); el nivel,
+     * la envolvente de todos los canales a la vez y la ganancia son SIMD.
+     */
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Igual, con el detector escuchando sidechain (al menos tantas muestras como el bloque)
+    template <typename ProcessContext, typename SidechainBlock>
+    void process(const ProcessContext& context, const SidechainBlock& sidechain) noexcept
+    {
+        jassert(sidechain.getNumSamples() >= context.getOutputBlock().getNumSamples());
+        processContextInFrames(context, makeFrameKernel(AudioLevelDetector::Sidechain::fromBlock(sidechain)));
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    // Función de trama (frame, numChannels, numValid), in-place; sólo las
+    // numValid primeras lanes avanzan la envolvente
+    auto makeFrameKernel(AudioLevelDetector::Sidechain sidechain = {}) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        // El tipo opto sólo escala la reducción en dB (pow(g, 0.8) == decibelsToGain(0.8 * dB))
+        const float typeScale = compressorType == CompressorType::kOpto ? 0.8f : 1.0f;
+        
+        return [this, typeScale, fast = fastMath, sidechain](Vec* frame, int numChannels, int numValid) mutable noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            const auto inputGainV = inputGain.nextFrame(numValid);
+            const auto outputGainV = outputGain.nextFrame(numValid);
+            const auto mixV = mix.nextFrame(numValid);
+            
+            // Umbral y pendiente por muestra para el bucle de la envolvente
+            alignas(32) float thresholdLanes[Vec::width];
+            alignas(32) float slopeLanes[Vec::width];
+            threshold.nextFrame(numValid).store(thresholdLanes);
+            slope.nextFrame(numValid).store(slopeLanes);
+            
+            Vec detectorInput[maxFrameChannels];
+            Vec gains[maxFrameChannels];
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+                detectorInput[ch] = sidechain.isActive() ? sidechain.load(ch, numValid) : frame[ch] * inputGainV;
+            
+            sidechain.advance(numValid);
+            
+            // Curva con knee, con los canales en lanes
+            detector.processFrame(detectorInput, gains, numChannels, numValid, fast, typeScale, [&](Vec envelope, int i, int)
+            {
+                return computeGainReduction(envelope, Vec(thresholdLanes[i]), Vec(slopeLanes[i]), knee);
+            });
+            
+            currentGainReduction = detector.getLastReduction();
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto dry = frame[ch];
+                const auto compressed = dry * inputGainV * gains[ch] * outputGainV;
+                frame[ch] = dry + (compressed - dry) * mixV;
+            }
+        };
+    }
+    
+    // Umbral, ratio, ganancias y mezcla van en rampa (AudioParameterSmoother)
+    void setThreshold(float newThreshold)
+    {
+        threshold.setTargetValue(newThreshold);
+    }
+    
+    void setRatio(float newRatio)
+    {
+        slope.setTargetValue(1.0f - 1.0f / juce::jlimit(1.0f, 20.0f, newRatio));
+    }
+    
+    void setAttack(float newAttack)
+    {
+        attack = juce::jlimit(0.1f, 100.0f, newAttack);
+        detector.setTimes(attack, release);
+    }
+    
+    void setRelease(float newRelease)
+    {
+        release = juce::jlimit(10.0f, 1000.0f, newRelease);
+        detector.setTimes(attack, release);
+    }
+    
+    // Envolvente por canal, o una sola con el máximo o la media de todos
+    void setDetectorLink(AudioLevelDetector::Link newLink)
+    {
+        detector.setLink(newLink);
+    }
+    
+    // Paso alto del detector (también con sidechain); 0 lo desactiva
+    void setDetectorHighPass(float frequencyHz)
+    {
+        detector.setHighPass(frequencyHz);
+    }
+    
+    // Pico o valor eficaz; el ataque y la liberación se aplican igual a los dos
+    void setDetectorMode(AudioLevelDetector::Mode newMode)
+    {
+        detector.setMode(newMode);
+    }
+    
+    // Ventana del valor eficaz, de 1 a AudioLevelDetector::maxRmsWindowMs
+    void setRmsWindow(float windowMs)
+    {
+        detector.setRmsWindow(windowMs);
+    }
+    
+    void setKnee(float newKnee)
+    {
+        knee = juce::jlimit(0.0f, 12.0f, newKnee);
+    }
+    
+    void setInputGain(float newGain)
+    {
+        inputGain.setTargetValue(juce::Decibels::decibelsToGain(newGain));
+    }
+    
+    void setOutputGain(float newGain)
+    {
+        outputGain.setTargetValue(juce::Decibels::decibelsToGain(newGain));
+    }
+    
+    void setMix(float newMix)
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+    
+    void setCompressorType(CompressorType newType)
+    {
+        compressorType = newType;
+    }
+    
+    float getGainReduction() const { return currentGainReduction; }
+    
+    // Detector y ganancia con AudioFastMath en lugar de log10/pow exactos
+    void setFastMath(bool shouldUseFastMath)
+    {
+        fastMath = shouldUseFastMath;
+    }
+    
+    // Curva de ganancia con knee suave: reducción en dB (>= 0) para una
+    // envolvente en dB. T es float (processSample) o AudioSimd::Vec (process),
+    // con el mismo resultado; también la usa AudioMultibandCompressor.
+    template <typename T>
+    static T computeGainReduction(T envelope, T threshold, T slope, float knee) noexcept
+    {
+        const auto overThreshold = envelope - threshold;
+        auto reduction = overThreshold * slope;
+        
+        if (knee > 0.0f)
+            reduction = AudioSimd::select(overThreshold < T(knee), overThreshold * (overThreshold / T(knee)) * slope * T(0.5f), reduction);
+        
+        return AudioSimd::select(envelope > threshold, reduction, T(0.0f));
+    }
+
+private:
+    float sampleRate = 44100.0f;
+    float attack = 5.0f;
+    float release = 50.0f;
+    float knee = 3.0f;
+    
+    AudioParameterSmoother threshold { -10.0f };
+    AudioParameterSmoother slope { 0.75f };     // 1 - 1 / ratio
+    AudioParameterSmoother inputGain { 1.0f, AudioParameterSmoother::Curve::kMultiplicative };
+    AudioParameterSmoother outputGain { 1.0f, AudioParameterSmoother::Curve::kMultiplicative };
+    AudioParameterSmoother mix { 1.0f };
+    
+    AudioLevelDetector detector;
+    float currentGainReduction = 0.0f;
+    
+    CompressorType compressorType = CompressorType::kVCA;
+    bool fastMath = false;
+};
+
+//==============================================================================
+// AudioExpander - Expansor/Gate de ruido
+//==============================================================================
+class AudioExpander
+{
+public:
+    AudioExpander() = default;
+    ~AudioExpander() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        threshold.prepare(spec.sampleRate);
+        expansionSlope.prepare(spec.sampleRate);
+        detector.setTimes(attack, release);
+        detector.prepare(spec.sampleRate);
+        reset();
+    }
+    
+    void reset()
+    {
+        detector.reset();
+    }
+    
+    template <typename SampleType>
+    SampleType processSample(SampleType input)
+    {
+        const auto currentThreshold = threshold.nextSample();
+        const auto currentSlope = expansionSlope.nextSample();
+        
+        // Detector de envolvente, como un solo canal
+        const auto envelope = detector.processSample(static_cast<float>(input), 0, fastMath);
+        
+        // Calcular expansión
+        SampleType gain = 1.0f;
+        
+        if (envelope < currentThreshold)
+        {
+            auto belowThreshold = currentThreshold - envelope;
+            auto expansion = belowThreshold * currentSlope;
+            gain = fastMath ? AudioFastMath::decibelsToGain(static_cast<float>(-expansion))
+                            : juce::Decibels::decibelsToGain(-expansion);
+        }
+        
+        return input * gain;
+    }
+    
+    // Proceso por bloques; detector enlazado por el máximo salvo setDetectorLink()
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Con el detector escuchando sidechain, p. ej. una puerta disparada por otra pista
+    template <typename ProcessContext, typename SidechainBlock>
+    void process(const ProcessContext& context, const SidechainBlock& sidechain) noexcept
+    {
+        jassert(sidechain.getNumSamples() >= context.getOutputBlock().getNumSamples());
+        processContextInFrames(context, makeFrameKernel(AudioLevelDetector::Sidechain::fromBlock(sidechain)));
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    auto makeFrameKernel(AudioLevelDetector::Sidechain sidechain = {}) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        return [this, fast = fastMath, sidechain](Vec* frame, int numChannels, int numValid) mutable noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            alignas(32) float thresholdLanes[Vec::width];
+            alignas(32) float slopeLanes[Vec::width];
+            threshold.nextFrame(numValid).store(thresholdLanes);
+            expansionSlope.nextFrame(numValid).store(slopeLanes);
+            
+            Vec detectorInput[maxFrameChannels];
+            Vec gains[maxFrameChannels];
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+                detectorInput[ch] = sidechain.isActive() ? sidechain.load(ch, numValid) : frame[ch];
+            
+            sidechain.advance(numValid);
+            
+            detector.processFrame(detectorInput, gains, numChannels, numValid, fast, 1.0f, [&](Vec envelope, int i, int)
+            {
+                const auto belowThreshold = Vec(thresholdLanes[i]) - envelope;
+                return AudioSimd::select(belowThreshold > Vec(0.0f), belowThreshold * Vec(slopeLanes[i]), Vec(0.0f));
+            });
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+                frame[ch] = frame[ch] * gains[ch];
+        };
+    }
+    
+    void setThreshold(float newThreshold)
+    {
+        threshold.setTargetValue(newThreshold);
+    }
+    
+    void setRatio(float newRatio)
+    {
+        expansionSlope.setTargetValue(juce::jlimit(1.0f, 10.0f, newRatio) - 1.0f);
+    }
+    
+    void setAttack(float newAttack)
+    {
+        attack = juce::jlimit(0.1f, 50.0f, newAttack);
+        detector.setTimes(attack, release);
+    }
+    
+    void setRelease(float newRelease)
+    {
+        release = juce::jlimit(10.0f, 500.0f, newRelease);
+        detector.setTimes(attack, release);
+    }
+    
+    void setDetectorLink(AudioLevelDetector::Link newLink)
+    {
+        detector.setLink(newLink);
+    }
+    
+    void setDetectorHighPass(float frequencyHz)
+    {
+        detector.setHighPass(frequencyHz);
+    }
+    
+    // Detector y ganancia con AudioFastMath en lugar de log10/pow exactos
+    void setFastMath(bool shouldUseFastMath)
+    {
+        fastMath = shouldUseFastMath;
+    }
+
+private:
+    float sampleRate = 44100.0f;
+    float attack = 1.0f;
+    float release = 100.0f;
+    
+    AudioParameterSmoother threshold { -40.0f };
+    AudioParameterSmoother expansionSlope { 1.0f };     // ratio - 1
+    
+    AudioLevelDetector detector;
+    bool fastMath = false;
+};
+
+//==============================================================================
+// AudioLimiter - Limitador brickwall con lookahead y true peak opcional
+//==============================================================================
+/**
+ * Limitador de techo para los buses de salida. La señal se retrasa el
+ * lookahead y la ganancia empieza a bajar antes de que llegue el pico, así
+ * que ninguna muestra pasa del techo:
+ *
+ *  1. Nivel: máximo de |x| de todos los canales (enlazados) o, con true peak,
+ *     de la señal reconstruida a 4x con un FIR polifásico corto.
+ *  2. Máximo deslizante del nivel sobre lookahead + 1 muestras con una cola
+ *     monótona: cada muestra entra y sale una sola vez, O(1) amortizado por
+ *     muestra sea cual sea la ventana.
+ *  3. Ganancia objetivo techo / máximo, release exponencial (el ataque es
+ *     instantáneo) y media móvil de lookahead + 1 muestras, que convierte el
+ *     escalón en una rampa que llega justo cuando llega el pico.
+ *
+ * El nivel, el FIR, la ganancia objetivo y su aplicación a cada canal van
+ * por lanes; la cola, el release y la suma móvil son recursiones de una única
+ * ganancia compartida por todos los canales, unas pocas operaciones escalares
+ * por muestra. La latencia es el lookahead más el retardo del FIR de true
+ * peak (getLatencySamples()).
+ */
+class AudioLimiter
+{
+public:
+    static constexpr float maxLookaheadMs = 20.0f;
+    
+    AudioLimiter() = default;
+    ~AudioLimiter() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        preparedSpec = spec;
+        sampleRate = static_cast<float>(spec.sampleRate);
+        numChannels = juce::jmin(static_cast<int>(spec.numChannels), maxFrameChannels);
+        
+        lookaheadSamples = static_cast<int>(std::lround(lookahead * 0.001 * spec.sampleRate));
+        delaySamples = lookaheadSamples + (truePeak ? truePeakDelay : 0);
+        
+        // Anillo potencia de dos con las primeras Vec::width muestras repetidas
+        // tras el final: cualquier trama, retrasada o para el FIR, se lee contigua
+        ringSize = juce::nextPowerOfTwo(juce::jmax(delaySamples, truePeakTaps) + AudioSimd::Vec::width);
+        ringStride = ringSize + AudioSimd::Vec::width;
+        delayLines.assign(static_cast<size_t>(numChannels * ringStride), 0.0f);
+        
+        // Con true peak el pico entre dos muestras se apunta en la primera; una
+        // muestra más de ventana lo mantiene también mientras sale la segunda
+        holdWindow.prepare(lookaheadSamples + 1 + (truePeak ? 1 : 0));
+        gainHistory.assign(static_cast<size_t>(lookaheadSamples + 1), 1.0f);
+        
+        updateReleaseCoefficient();
+        reset();
+    }
+    
+    void reset()
+    {
+        std::fill(delayLines.begin(), delayLines.end(), 0.0f);
+        writePosition = 0;
+        
+        holdWindow.reset();
+        std::fill(gainHistory.begin(), gainHistory.end(), 1.0f);
+        gainHistoryIndex = 0;
+        gainSum = static_cast<double>(gainHistory.size());
+        releasedGain = 1.0f;
+        lastGain = 1.0f;
+    }
+    
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    // Función de trama (frame, numChannels, numValid), in-place; los canales
+    // más allá de los de prepare() no pasan por el limitador
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        return [this, ceilingV = Vec(ceiling), detectTruePeak = truePeak](Vec* frame, int frameChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            jassert(frameChannels <= numChannels);
+            const int channels = juce::jmin(frameChannels, numChannels);
+            const int position = writePosition;
+            
+            // Nivel enlazado; el del FIR corresponde a la muestra position - truePeakDelay
+            Vec level(0.0f);
+            
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                auto* ring = getDelayLine(ch);
+                writeFrame(ring, position, frame[ch], numValid);
+                level = AudioSimd::max(level, detectTruePeak ? getTruePeakLevel(ring, position) : AudioSimd::abs(frame[ch]));
+            }
+            
+            alignas(32) float lanes[Vec::width];
+            level.store(lanes);
+            
+            for (int i = 0; i < numValid; ++i)
+                lanes[i] = holdWindow.push(lanes[i]);
+            
+            const auto target = ceilingV / AudioSimd::max(Vec::load(lanes), ceilingV);
+            target.store(lanes);
+            
+            for (int i = 0; i < numValid; ++i)
+                lanes[i] = smoothGain(lanes[i]);
+            
+            lastGain = lanes[numValid - 1];
+            const auto gain = Vec::load(lanes);
+            
+            for (int ch = 0; ch < channels; ++ch)
+                frame[ch] = readFrame(getDelayLine(ch), position, delaySamples) * gain;
+            
+            writePosition = (position + numValid) & (ringSize - 1);
+        };
+    }
+    
+    // Techo en dBFS (dBTP con true peak)
+    void setCeiling(float newCeilingDb)
+    {
+        ceiling = juce::Decibels::decibelsToGain(juce::jlimit(-24.0f, 0.0f, newCeilingDb));
+    }
+    
+    void setRelease(float newRelease)
+    {
+        release = juce::jlimit(1.0f, 1000.0f, newRelease);
+        updateReleaseCoefficient();
+    }
+    
+    /**
+     * Lookahead en ms y detección true peak (4x, al estilo de ITU-R BS.1770).
+     * Cambian la latencia, reservan memoria y rehacen el estado que usa
+     * process(): llamar fuera del hilo de audio, con el callback detenido.
+     */
+    void setLookahead(float newLookahead)
+    {
+        lookahead = juce::jlimit(0.0f, maxLookaheadMs, newLookahead);
+        prepare(preparedSpec);
+    }
+    
+    void setTruePeak(bool shouldDetectTruePeak)
+    {
+        truePeak = shouldDetectTruePeak;
+        prepare(preparedSpec);
+    }
+    
+    bool isTruePeak() const noexcept { return truePeak; }
+    
+    int getLatencySamples() const noexcept { return delaySamples; }
+    
+    // Reducción de la última muestra, en dB positivos
+    float getGainReduction() const { return -juce::Decibels::gainToDecibels(lastGain); }
+
+private:
+    // Máximo de las últimas length muestras: la cola guarda, en orden, los
+    // valores que aún pueden llegar a ser el máximo, así que es decreciente
+    struct SlidingMaximum
+    {
+        void prepare(int newLength)
+        {
+            length = juce::jmax(1, newLength);
+            values.assign(static_cast<size_t>(length), 0.0f);
+            times.assign(static_cast<size_t>(length), 0);
+            reset();
+        }
+        
+        void reset() noexcept
+        {
+            head = 0;
+            count = 0;
+            time = 0;
+        }
+        
+        float push(float value) noexcept
+        {
+            // El más antiguo caduca al salir de la ventana
+            if (count > 0 && times[static_cast<size_t>(head)] <= time - length)
+            {
+                head = wrap(head + 1);
+                --count;
+            }
+            
+            // Lo que no supera al valor nuevo ya no puede ser el máximo
+            while (count > 0 && values[static_cast<size_t>(wrap(head + count - 1))] <= value)
+                --count;
+            
+            const auto tail = static_cast<size_t>(wrap(head + count));
+            values[tail] = value;
+            times[tail] = time++;
+            ++count;
+            
+            return values[static_cast<size_t>(head)];
+        }
+        
+        int wrap(int index) const noexcept { return index >= length ? index - length : index; }
+        
+        std::vector<float> values;
+        std::vector<juce::int64> times;
+        int length = 1;
+        int head = 0;
+        int count = 0;
+        juce::int64 time = 0;
+    };
+    
+    // Ataque instantáneo y release exponencial, luego la media móvil. Nunca
+    // supera la ganancia que pedía la muestra que sale ahora por el retardo,
+    // la más antigua de la media, así que el techo no depende del redondeo.
+    float smoothGain(float target) noexcept
+    {
+        releasedGain = juce::jmin(target, releasedGain + (target - releasedGain) * releaseCoefficient);
+        
+        auto& oldest = gainHistory[static_cast<size_t>(gainHistoryIndex)];
+        gainSum += static_cast<double>(releasedGain) - static_cast<double>(oldest);
+        oldest = releasedGain;
+        
+        // Al dar la vuelta se recalcula la suma para que no acumule error
+        if (++gainHistoryIndex == static_cast<int>(gainHistory.size()))
+        {
+            gainHistoryIndex = 0;
+            gainSum = std::accumulate(gainHistory.begin(), gainHistory.end(), 0.0);
+        }
+        
+        const auto average = static_cast<float>(gainSum / static_cast<double>(gainHistory.size()));
+        return juce::jmin(average, gainHistory[static_cast<size_t>(gainHistoryIndex)]);
+    }
+    
+    void updateReleaseCoefficient() noexcept
+    {
+        releaseCoefficient = 1.0f - std::exp(-1.0f / (release * 0.001f * sampleRate));
+    }
+    
+    float* getDelayLine(int channel) noexcept
+    {
+        return delayLines.data() + channel * ringStride;
+    }
+    
+    // Escribe numValid muestras desde position, repitiendo tras el final las
+    // que caen en las primeras Vec::width posiciones del anillo
+    void writeFrame(float* ring, int position, AudioSimd::Vec samples, int numValid) const noexcept
+    {
+        alignas(32) float lanes[AudioSimd::Vec::width];
+        samples.store(lanes);
+        
+        for (int i = 0; i < numValid; ++i)
+        {
+            const int index = (position + i) & (ringSize - 1);
+            ring[index] = lanes[i];
+            
+            if (index < AudioSimd::Vec::width)
+                ring[index + ringSize] = lanes[i];
+        }
+    }
+    
+    // La trama que empieza delay muestras antes de position
+    AudioSimd::Vec readFrame(const float* ring, int position, int delay) const noexcept
+    {
+        return AudioSimd::Vec::load(ring + ((position - delay) & (ringSize - 1)));
+    }
+    
+    //==============================================================================
+    // True peak: tres fases interpoladas a 1/4, 1/2 y 3/4 entre las muestras
+    // position - truePeakDelay y la siguiente, más la propia muestra
+    static constexpr int truePeakTaps = 12;
+    static constexpr int truePeakDelay = truePeakTaps / 2;
+    static constexpr int truePeakPhases = 3;
+    
+    using TruePeakCoefficients = std::array<std::array<float, truePeakTaps>, truePeakPhases>;
+    
+    // Sinc con ventana de Blackman, cada fase normalizada a ganancia 1 en continua
+    static const TruePeakCoefficients& getTruePeakCoefficients() noexcept
+    {
+        static const TruePeakCoefficients coefficients = []
+        {
+            TruePeakCoefficients design {};
+            const double halfWidth = truePeakDelay + 0.5;
+            
+            for (int phase = 0; phase < truePeakPhases; ++phase)
+            {
+                double sum = 0.0;
+                
+                for (int tap = 0; tap < truePeakTaps; ++tap)
+                {
+                    const double t = tap - truePeakDelay + (phase + 1) * 0.25;
+                    const double x = juce::MathConstants<double>::pi * t;
+                    const double window = 0.42 + 0.5 * std::cos(x / halfWidth) + 0.08 * std::cos(2.0 * x / halfWidth);
+                    const double value = std::sin(x) / x * window;
+                    
+                    design[static_cast<size_t>(phase)][static_cast<size_t>(tap)] = static_cast<float>(value);
+                    sum += value;
+                }
+                
+                for (auto& c : design[static_cast<size_t>(phase)])
+                    c = static_cast<float>(c / sum);
+            }
+            
+            return design;
+        }();
+        
+        return coefficients;
+    }
+    
+    AudioSimd::Vec getTruePeakLevel(const float* ring, int position) const noexcept
+    {
+        using AudioSimd::Vec;
+        
+        const auto& coefficients = getTruePeakCoefficients();
+        Vec phases[truePeakPhases] = { Vec(0.0f), Vec(0.0f), Vec(0.0f) };
+        
+        for (int tap = 0; tap < truePeakTaps; ++tap)
+        {
+            const auto x = readFrame(ring, position, tap);
+            
+            for (int phase = 0; phase < truePeakPhases; ++phase)
+                phases[phase] = phases[phase] + x * Vec(coefficients[static_cast<size_t>(phase)][static_cast<size_t>(tap)]);
+        }
+        
+        auto level = AudioSimd::abs(readFrame(ring, position, truePeakDelay));
+        
+        for (const auto& interpolated : phases)
+            level = AudioSimd::max(level, AudioSimd::abs(interpolated));
+        
+        return level;
+    }
+    
+    float sampleRate = 44100.0f;
+    float ceiling = 0.891250938f;   // -1 dB
+    float release = 100.0f;
+    float releaseCoefficient = 0.0f;
+    float lookahead = 5.0f;
+    bool truePeak = false;
+    
+    int numChannels = 0;
+    int lookaheadSamples = 0;
+    int delaySamples = 0;
+    
+    // Retardo de cada canal, que es también la historia del FIR de true peak
+    std::vector<float> delayLines;
+    int ringSize = 0;
+    int ringStride = 0;
+    int writePosition = 0;
+    
+    SlidingMaximum holdWindow;
+    std::vector<float> gainHistory;     // ganancias tras el release, para la media móvil
+    int gainHistoryIndex = 0;
+    double gainSum = 0.0;
+    float releasedGain = 1.0f;
+    float lastGain = 1.0f;
+    
+    juce::dsp::ProcessSpec preparedSpec { 44100.0, 512, 2 };
+};
+
+//==============================================================================
+// AudioMultibandCompressor - Compresor de 3 a 5 bandas con cruces Linkwitz-Riley
+//==============================================================================
+/**
+ * Divide la señal con cruces Linkwitz-Riley de cuarto orden y comprime cada
+ * banda con la curva de AudioCompressor. Cada banda sale directamente de la
+ * entrada por una sección por cruce: paso bajo LR4 en su cruce superior, paso
+ * alto LR4 en los inferiores y, en los de más arriba, el pasa todo que es la
+ * suma LP + HP de ese cruce. Así todas las bandas llevan la misma fase y, sin
+ * compresión, suman un pasa todo plano en magnitud.
+ *
+ * Como ninguna banda depende de otra, las bandas ocupan las lanes de un Vec
+ * y cada muestra pasa por dos biquads vectoriales por cruce, para todas a la
+ * vez. El detector es un único AudioLevelDetector con una envolvente por
+ * banda (enlazada entre canales por el máximo): la detección de todas las
+ * bandas es también una sola pasada por lanes.
+ *
+ * Las bandas viven en arrays de la trama, sin buffers por bloque ni memoria
+ * en el hilo de audio. Umbral, ratio y makeup de cada banda van en rampa
+ * (AudioParameterSmoother), como en AudioCompressor.
+ */
+class AudioMultibandCompressor
+{
+public:
+    static constexpr int minBands = 3;
+    static constexpr int maxBands = 5;
+    
+    AudioMultibandCompressor()
+    {
+        detector.setLink(AudioLevelDetector::Link::kIndependent);
+        
+        for (int band = 0; band < maxBands; ++band)
+        {
+            setBandRatio(band, 2.0f);
+            setBandThreshold(band, -18.0f);
+            setBandTimes(band, 10.0f, 100.0f);
+        }
+    }
+    
+    ~AudioMultibandCompressor() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        
+        for (int band = 0; band < maxBands; ++band)
+            for (auto* parameter : { &thresholds[static_cast<size_t>(band)], &slopes[static_cast<size_t>(band)], &makeups[static_cast<size_t>(band)] })
+                parameter->prepare(spec.sampleRate);
+        
+        detector.prepare(spec.sampleRate);
+        coefficientsDirty = true;
+        reset();
+    }
+    
+    void reset()
+    {
+        state1.fill(0.0f);
+        state2.fill(0.0f);
+        bandReductions.fill(0.0f);
+        detector.reset();
+    }
+    
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        updateCoefficientsIfNeeded();
+        
+        return [this, fast = fastMath](Vec* frame, int numChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            constexpr int width = Vec::width;
+            const int groups = (activeBands + width - 1) / width;
+            
+            // Bandas de cada canal, una fila por muestra con las bandas en columnas
+            alignas(32) float split[maxFrameChannels][width][bandLanes];
+            alignas(32) float levels[width][bandLanes] = {};
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int group = 0; group < groups; ++group)
+                {
+                    const int offset = group * width;
+                    Vec rows[width];
+                    
+                    splitFrame(frame[ch], rows, ch, offset, numValid);
+                    
+                    for (int i = 0; i < numValid; ++i)
+                    {
+                        rows[i].store(split[ch][i] + offset);
+                        AudioSimd::max(Vec::load(levels[i] + offset), AudioSimd::abs(rows[i])).store(levels[i] + offset);
+                    }
+                }
+            }
+            
+            // Una pasada del detector para todas las bandas, cada una como un canal
+            Vec detectorInput[maxBands];
+            Vec gains[maxBands];
+            Vec makeupGains[maxBands];
+            
+            // Umbral y pendiente por muestra, una fila por muestra como levels;
+            // las lanes de relleno nunca comprimen
+            alignas(32) float thresholdRows[width][bandLanes];
+            alignas(32) float slopeRows[width][bandLanes];
+            
+            for (int i = 0; i < width; ++i)
+            {
+                std::fill(thresholdRows[i] + activeBands, thresholdRows[i] + bandLanes, 1000.0f);
+                std::fill(slopeRows[i] + activeBands, slopeRows[i] + bandLanes, 0.0f);
+            }
+            
+            for (int band = 0; band < activeBands; ++band)
+            {
+                alignas(32) float thresholdLanes[width];
+                alignas(32) float slopeLanes[width];
+                thresholds[static_cast<size_t>(band)].nextFrame(numValid).store(thresholdLanes);
+                slopes[static_cast<size_t>(band)].nextFrame(numValid).store(slopeLanes);
+                
+                for (int i = 0; i < width; ++i)
+                {
+                    thresholdRows[i][band] = thresholdLanes[i];
+                    slopeRows[i][band] = slopeLanes[i];
+                }
+                
+                detectorInput[band] = transposeColumn(levels, band, numValid);
+                makeupGains[band] = makeups[static_cast<size_t>(band)].nextFrame(numValid);
+            }
+            
+            detector.processFrame(detectorInput, gains, activeBands, numValid, fast, 1.0f, [&](Vec envelope, int i, int offset)
+            {
+                const auto reduction = AudioCompressor::computeGainReduction(envelope, Vec::load(thresholdRows[i] + offset),
+                                                                             Vec::load(slopeRows[i] + offset), knee);
+                
+                if (i == numValid - 1)
+                    reduction.store(bandReductions.data() + offset);
+                
+                return reduction;
+            });
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                Vec output(0.0f);
+                
+                for (int band = 0; band < activeBands; ++band)
+                    output = output + transposeColumn(split[ch], band, numValid) * gains[band] * makeupGains[band];
+                
+                frame[ch] = output;
+            }
+        };
+    }
+    
+    // Cambia la topología: el estado de los cruces vuelve a cero
+    void setNumBands(int newNumBands)
+    {
+        numBands = juce::jlimit(minBands, maxBands, newNumBands);
+        coefficientsDirty = true;
+    }
+    
+    int getNumBands() const noexcept { return numBands; }
+    
+    // Cruce index (0 = el más grave); se mantiene entre sus vecinos
+    void setCrossover(int index, float frequencyHz)
+    {
+        jassert(juce::isPositiveAndBelow(index, maxBands - 1));
+        const float lower = index > 0 ? crossovers[static_cast<size_t>(index - 1)] : 20.0f;
+        const float upper = index < maxBands - 2 ? crossovers[static_cast<size_t>(index + 1)] : 20000.0f;
+        
+        crossovers[static_cast<size_t>(index)] = juce::jlimit(lower, upper, frequencyHz);
+        coefficientsDirty = true;
+    }
+    
+    // Umbral, ratio y makeup van en rampa (AudioParameterSmoother)
+    void setBandThreshold(int band, float thresholdDb)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        thresholds[static_cast<size_t>(band)].setTargetValue(juce::jlimit(-60.0f, 0.0f, thresholdDb));
+    }
+    
+    void setBandRatio(int band, float ratio)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        slopes[static_cast<size_t>(band)].setTargetValue(1.0f - 1.0f / juce::jlimit(1.0f, 20.0f, ratio));
+    }
+    
+    void setBandTimes(int band, float attackMs, float releaseMs)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        detector.setChannelTimes(band, juce::jlimit(0.1f, 100.0f, attackMs), juce::jlimit(10.0f, 1000.0f, releaseMs));
+    }
+    
+    void setBandMakeup(int band, float gainDb)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        makeups[static_cast<size_t>(band)].setTargetValue(juce::Decibels::decibelsToGain(juce::jlimit(-12.0f, 24.0f, gainDb)));
+    }
+    
+    void setKnee(float newKnee)
+    {
+        knee = juce::jlimit(0.0f, 12.0f, newKnee);
+    }
+    
+    void setFastMath(bool shouldUseFastMath)
+    {
+        fastMath = shouldUseFastMath;
+    }
+    
+    // Reducción (dB) de la banda en la última muestra procesada, para medidores
+    float getBandGainReduction(int band) const noexcept
+    {
+        return bandReductions[static_cast<size_t>(band)];
+    }
+
+private:
+    static constexpr int numSections = 2 * (maxBands - 1);     // dos biquads por cruce
+    static constexpr int bandLanes = (maxBands + AudioSimd::Vec::width - 1) / AudioSimd::Vec::width * AudioSimd::Vec::width;
+    
+    // Pasa las muestras de la trama por las secciones de las bandas offset..
+    // offset + Vec::width - 1: rows[i] sale con esas bandas de la muestra i
+    void splitFrame(AudioSimd::Vec input, AudioSimd::Vec* rows, int channel, int offset, int numValid) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        alignas(32) float samples[Vec::width];
+        input.store(samples);
+        
+        for (int i = 0; i < numValid; ++i)
+            rows[i] = Vec(samples[i]);
+        
+        // Sección a sección sobre toda la trama, con el estado en registros
+        for (int section = 0; section < 2 * (activeBands - 1); ++section)
+        {
+            const int index = section * bandLanes + offset;
+            const auto c0 = Vec::load(b0.data() + index);
+            const auto c1 = Vec::load(b1.data() + index);
+            const auto c2 = Vec::load(b2.data() + index);
+            const auto d1 = Vec::load(a1.data() + index);
+            const auto d2 = Vec::load(a2.data() + index);
+            
+            auto* sectionState1 = state1.data() + channel * numSections * bandLanes + index;
+            auto* sectionState2 = state2.data() + channel * numSections * bandLanes + index;
+            auto s1 = Vec::load(sectionState1);
+            auto s2 = Vec::load(sectionState2);
+            
+            for (int i = 0; i < numValid; ++i)
+            {
+                const auto x = rows[i];
+                const auto y = c0 * x + s1;
+                
+                s1 = c1 * x - d1 * y + s2;
+                s2 = c2 * x - d2 * y;
+                rows[i] = y;
+            }
+            
+            s1.store(sectionState1);
+            s2.store(sectionState2);
+        }
+    }
+    
+    // Columna de una tabla [muestra][banda] como trama; las lanes sin muestra a cero
+    static AudioSimd::Vec transposeColumn(const float (*table)[bandLanes], int column, int numValid) noexcept
+    {
+        alignas(32) float lanes[AudioSimd::Vec::width];
+        
+        for (int i = 0; i < AudioSimd::Vec::width; ++i)
+            lanes[i] = i < numValid ? table[i][column] : 0.0f;
+        
+        return AudioSimd::Vec::load(lanes);
+    }
+    
+    void updateCoefficientsIfNeeded() noexcept
+    {
+        if (!coefficientsDirty)
+            return;
+        
+        coefficientsDirty = false;
+        
+        if (activeBands != numBands)
+        {
+            activeBands = numBands;
+            state1.fill(0.0f);
+            state2.fill(0.0f);
+        }
+        
+        // Identidad en las lanes sin banda y en las secciones sin cruce
+        b0.fill(1.0f);
+        b1.fill(0.0f);
+        b2.fill(0.0f);
+        a1.fill(0.0f);
+        a2.fill(0.0f);
+        
+        for (int crossover = 0; crossover < activeBands - 1; ++crossover)
+        {
+            // Butterworth (Q = 1/sqrt(2)) de RBJ; dos en serie hacen el LR4
+            const double frequency = juce::jmin(static_cast<double>(crossovers[static_cast<size_t>(crossover)]), 0.45 * sampleRate);
+            const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            const double cosOmega = std::cos(omega);
+            const double alpha = std::sin(omega) / std::sqrt(2.0);
+            const double a0 = 1.0 + alpha;
+            const auto feedback1 = static_cast<float>(-2.0 * cosOmega / a0);
+            const auto feedback2 = static_cast<float>((1.0 - alpha) / a0);
+            
+            for (int band = 0; band < activeBands; ++band)
+            {
+                const auto first = static_cast<size_t>(2 * crossover * bandLanes + band);
+                const auto second = first + static_cast<size_t>(bandLanes);
+                
+                if (band > crossover)
+                {
+                    // Por encima del cruce: paso alto
+                    b0[first] = b0[second] = b2[first] = b2[second] = static_cast<float>((1.0 + cosOmega) * 0.5 / a0);
+                    b1[first] = b1[second] = static_cast<float>(-(1.0 + cosOmega) / a0);
+                }
+                else if (band == crossover)
+                {
+                    // Cruce superior de la banda: paso bajo
+                    b0[first] = b0[second] = b2[first] = b2[second] = static_cast<float>((1.0 - cosOmega) * 0.5 / a0);
+                    b1[first] = b1[second] = static_cast<float>((1.0 - cosOmega) / a0);
+                }
+                else
+                {
+                    // Por debajo: LP + HP del cruce, el pasa todo de segundo orden
+                    b0[first] = feedback2;
+                    b1[first] = feedback1;
+                    b2[first] = 1.0f;
+                    a1[first] = feedback1;
+                    a2[first] = feedback2;
+                    continue;
+                }
+                
+                a1[first] = a1[second] = feedback1;
+                a2[first] = a2[second] = feedback2;
+            }
+        }
+    }
+    
+    float sampleRate = 44100.0f;
+    int numBands = minBands;
+    int activeBands = 0;        // las del último cálculo de coeficientes
+    std::array<float, maxBands - 1> crossovers { 150.0f, 1500.0f, 5000.0f, 12000.0f };
+    bool coefficientsDirty = true;
+    
+    // Coeficientes [sección * bandLanes + banda]
+    alignas(32) std::array<float, numSections * bandLanes> b0 {};
+    alignas(32) std::array<float, numSections * bandLanes> b1 {};
+    alignas(32) std::array<float, numSections * bandLanes> b2 {};
+    alignas(32) std::array<float, numSections * bandLanes> a1 {};
+    alignas(32) std::array<float, numSections * bandLanes> a2 {};
+    
+    // Estado [(canal * numSections + sección) * bandLanes + banda]
+    alignas(32) std::array<float, maxFrameChannels * numSections * bandLanes> state1 {};
+    alignas(32) std::array<float, maxFrameChannels * numSections * bandLanes> state2 {};
+    
+    // Curva por banda
+    std::array<AudioParameterSmoother, maxBands> thresholds;
+    std::array<AudioParameterSmoother, maxBands> slopes;       // 1 - 1 / ratio
+    alignas(32) std::array<float, bandLanes> bandReductions {};
+    std::array<AudioParameterSmoother, maxBands> makeups {{
+        AudioParameterSmoother { 1.0f, AudioParameterSmoother::Curve::kMultiplicative },
+        AudioParameterSmoother { 1.0f, AudioParameterSmoother::Curve::kMultiplicative },
+        AudioParameterSmoother { 1.0f, AudioParameterSmoother::Curve::kMultiplicative },
+        AudioParameterSmoother { 1.0f, AudioParameterSmoother::Curve::kMultiplicative },
+        AudioParameterSmoother { 1.0f, AudioParameterSmoother::Curve::kMultiplicative }
+    }};
+    float knee = 3.0f;
+    bool fastMath = false;
+    
+    AudioLevelDetector detector;
+};
+
+//==============================================================================
+// AudioDistortion - Distorsión con múltiples tipos de clippers
+//==============================================================================
+class AudioDistortion
+{
+public:
+    enum class ClipperType
+    {
+        kSoft,
+        kHard,
+        kTube,
+        kFoldback
+    };
+    
+    AudioDistortion() = default;
+    ~AudioDistortion() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        previousDriven.assign(spec.numChannels, 0.0f);
+        preparedSpec = spec;
+        oversampler.prepare(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize),
+                            oversamplingFactor, oversamplingQuality);
+        prepareParameters();
+    }
+    
+    // channel importa con antialiasing, que guarda la muestra anterior de cada
+    // canal; los parámetros avanzan una vez por muestra, en la llamada del canal 0
+    template <typename SampleType>
+    SampleType processSample(SampleType input, int channel = 0)
+    {
+        auto next = [channel](AudioParameterSmoother& parameter) { return channel == 0 ? parameter.nextSample() : parameter.getCurrentValue(); };
+        const auto currentDrive = next(drive);
+        const auto currentMix = next(mix);
+        const auto currentOutputGain = next(outputGain);
+        
+        const auto driven = static_cast<float>(input * currentDrive);
+        float sample = driven;
+        
+        // Aplicar tipo de clipper
+        switch (clipperType)
+        {
+            case ClipperType::kSoft:
+                sample = fastMath ? clipSample<ClipperType::kSoft, true>(driven, channel)
+                                  : clipSample<ClipperType::kSoft, false>(driven, channel);
+                break;
+            
+            case ClipperType::kHard:
+                sample = clipSample<ClipperType::kHard, false>(driven, channel);
+                break;
+            
+            case ClipperType::kTube:
+                sample = clipSample<ClipperType::kTube, false>(driven, channel);
+                break;
+            
+            case ClipperType::kFoldback:
+                sample = clipSample<ClipperType::kFoldback, false>(driven, channel);
+                break;
+        }
+        
+        // Mix y output gain
+        auto output = input + (static_cast<SampleType>(sample) - input) * currentMix;
+        return output * currentOutputGain;
+    }
+    
+    // Proceso por bloques: el tipo de clipper se resuelve una vez por bloque.
+    // Con sobremuestreo el clipper y la mezcla trabajan a la frecuencia alta.
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        if (oversampler.isActive())
+        {
+            processContextOversampled(context, oversampler, [this](const auto& upContext)
+            {
+                visitClipperKernel([&upContext](auto& kernel) { processContextInFrames(upContext, kernel); });
+            });
+            
+            return;
+        }
+        
+        visitClipperKernel([&context](auto& kernel) { processContextInFrames(context, kernel); });
+    }
+    
+    // Para AudioProcessorChain, que trabaja a la frecuencia base: una etapa
+    // con sobremuestreo se procesa con process() fuera de la cadena
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        jassert(!oversampler.isActive());
+        visitClipperKernel(visitor);
+    }
+    
+    // Llama a visitor con la función de trama especializada para el clipper
+    // actual; así ni process() ni AudioProcessorChain deciden nada por trama
+    template <typename Visitor>
+    void visitClipperKernel(Visitor&& visitor) noexcept
+    {
+        if (antialiasing)
+            visitClipperKernelFor<true>(visitor);
+        else
+            visitClipperKernelFor<false>(visitor);
+    }
+    
+    template <bool antialiased, typename Visitor>
+    void visitClipperKernelFor(Visitor& visitor) noexcept
+    {
+        switch (clipperType)
+        {
+            case ClipperType::kSoft:
+                if (fastMath)
+                    invokeWithKernel<ClipperType::kSoft, true, antialiased>(visitor);
+                else
+                    invokeWithKernel<ClipperType::kSoft, false, antialiased>(visitor);
+                break;
+            case ClipperType::kHard:     invokeWithKernel<ClipperType::kHard, false, antialiased>(visitor);     break;
+            case ClipperType::kTube:     invokeWithKernel<ClipperType::kTube, false, antialiased>(visitor);     break;
+            case ClipperType::kFoldback: invokeWithKernel<ClipperType::kFoldback, false, antialiased>(visitor); break;
+        }
+    }
+    
+    template <ClipperType type, bool fast, bool antialiased, typename Visitor>
+    void invokeWithKernel(Visitor& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel<type, fast, antialiased>();
+        visitor(kernel);
+    }
+    
+    template <ClipperType type, bool fast, bool antialiased>
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        return [this](Vec* frame, int numChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            const auto driveV = drive.nextFrame(numValid);
+            const auto mixV = mix.nextFrame(numValid);
+            const auto outputGainV = outputGain.nextFrame(numValid);
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto dry = frame[ch];
+                const auto driven = dry * driveV;
+                Vec clipped;
+                
+                if constexpr (antialiased)
+                {
+                    // Canales más allá de los de prepare() se quedan sin antialiasing
+                    if (ch < static_cast<int>(previousDriven.size()))
+                        clipped = clipAntialiasedFrame<type, fast>(driven, previousDriven[static_cast<size_t>(ch)], numValid);
+                    else
+                        clipped = clip<type, fast>(driven);
+                }
+                else
+                {
+                    clipped = clip<type, fast>(driven);
+                }
+                
+                frame[ch] = (dry + (clipped - dry) * mixV) * outputGainV;
+            }
+        };
+    }
+    
+    void reset()
+    {
+        std::fill(previousDriven.begin(), previousDriven.end(), 0.0f);
+        oversampler.reset();
+    }
+    
+    /**
+     * Antialiasing por antiderivada de primer orden (ADAA): en vez de f(x[n])
+     * se usa (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), la media de f sobre el
+     * segmento entre dos muestras, que atenúa los armónicos que se doblan por
+     * encima de Nyquist sin subir la frecuencia. Cuesta un clipper y una
+     * antiderivada más por muestra, siempre lo mismo. El clipper retrasa
+     * media muestra respecto a la señal seca de la mezcla.
+     */
+    void setAntialiasing(bool shouldUseAntialiasing)
+    {
+        antialiasing = shouldUseAntialiasing;
+    }
+    
+    bool isAntialiasing() const noexcept { return antialiasing; }
+    
+    /**
+     * Sobremuestreo 1x (desactivado), 2x, 4x u 8x para reducir el aliasing de
+     * los clippers con mucho drive. Reserva memoria y rehace el estado que usa
+     * process(): llamar fuera del hilo de audio, con el callback detenido. La
+     * latencia resultante está en getLatencySamples().
+     */
+    void setOversampling(int factor, AudioOversampler::Quality quality)
+    {
+        oversamplingFactor = factor;
+        oversamplingQuality = quality;
+        oversampler.prepare(static_cast<int>(preparedSpec.numChannels), static_cast<int>(preparedSpec.maximumBlockSize),
+                            oversamplingFactor, oversamplingQuality);
+        prepareParameters();
+    }
+    
+    int getOversamplingFactor() const noexcept { return oversamplingFactor; }
+    
+    int getLatencySamples() const noexcept
+    {
+        return oversampler.isActive() ? oversampler.getLatencySamples() : 0;
+    }
+    
+    // Drive, mezcla y ganancia van en rampa (AudioParameterSmoother)
+    void setDrive(float newDrive)
+    {
+        drive.setTargetValue(juce::jlimit(1.0f, 50.0f, newDrive));
+    }
+    
+    void setMix(float newMix)
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+    
+    void setOutputGain(float newGain)
+    {
+        outputGain.setTargetValue(juce::jlimit(0.0f, 2.0f, newGain));
+    }
+    
+    void setClipperType(ClipperType newType)
+    {
+        clipperType = newType;
+    }
+    
+    // tanh del clipper suave con AudioFastMath
+    void setFastMath(bool shouldUseFastMath)
+    {
+        fastMath = shouldUseFastMath;
+    }
+
+private:
+    // Clippers en forma cerrada, sin saltos ni bucles: T es float (processSample)
+    // o AudioSimd::Vec (process), con el mismo resultado en ambos casos
+    template <ClipperType type, bool fast, typename T>
+    static T clip(T x) noexcept
+    {
+        if constexpr (type == ClipperType::kSoft)
+        {
+            if constexpr (fast)
+                return AudioFastMath::tanh(x);
+            else if constexpr (std::is_same_v<T, float>)
+                return std::tanh(x);
+            else
+                return x.map([](float sample) { return std::tanh(sample); });
+        }
+        else if constexpr (type == ClipperType::kHard)
+        {
+            return AudioSimd::min(AudioSimd::max(x, T(-1.0f)), T(1.0f));
+        }
+        else if constexpr (type == ClipperType::kTube)
+        {
+            const auto magnitude = AudioSimd::abs(x);
+            const auto sign = AudioSimd::select(x > T(0.0f), T(1.0f), T(-1.0f));
+            const auto knee = T(2.0f) - T(3.0f) * magnitude;
+            const auto curved = (T(3.0f) - knee * knee) / T(3.0f) * sign;
+            
+            return AudioSimd::select(magnitude < T(1.0f / 3.0f), x * T(2.0f),
+                                     AudioSimd::select(magnitude < T(2.0f / 3.0f), curved, sign));
+        }
+        else
+        {
+            // Plegado como onda triangular de periodo 4: el mismo resultado que
+            // reflejar en +-1 hasta entrar en rango, con coste fijo
+            const auto shifted = x + T(1.0f);
+            const auto wrapped = shifted - T(4.0f) * AudioSimd::floor(shifted * T(0.25f));
+            return T(1.0f) - AudioSimd::abs(wrapped - T(2.0f));
+        }
+    }
+    
+    //==============================================================================
+    // Antiderivadas para el ADAA. Se escriben como F(x) = |x| + R(x) (sólo R en
+    // el plegado, que es periódico) con R acotada, para que F(x) - F(x0) no
+    // pierda precisión restando dos números grandes cuando el drive es alto.
+    template <ClipperType type, bool fast, typename T>
+    static T antiderivativeRemainder(T x) noexcept
+    {
+        const auto magnitude = AudioSimd::abs(x);
+        
+        if constexpr (type == ClipperType::kSoft)
+        {
+            // log(cosh(x)) = |x| + log(1 + e^(-2|x|)) - log(2)
+            if constexpr (fast)
+                return T(0.693147181f) * (AudioFastMath::log2(T(1.0f) + AudioFastMath::exp2(magnitude * T(-2.88539008f))) - T(1.0f));
+            else if constexpr (std::is_same_v<T, float>)
+                return std::log1p(std::exp(-2.0f * magnitude)) - 0.693147181f;
+            else
+                return magnitude.map([](float a) { return std::log1p(std::exp(-2.0f * a)) - 0.693147181f; });
+        }
+        else if constexpr (type == ClipperType::kHard)
+        {
+            // x^2 / 2 dentro de [-1, 1], |x| - 1/2 fuera
+            return AudioSimd::select(magnitude < T(1.0f), magnitude * (magnitude * T(0.5f) - T(1.0f)), T(-0.5f));
+        }
+        else if constexpr (type == ClipperType::kTube)
+        {
+            // x^2, |x| - 7/27 + (2 - 3|x|)^3 / 27 y |x| - 7/27 en los tres tramos
+            const auto knee = T(2.0f) - T(3.0f) * magnitude;
+            const auto curved = (knee * knee * knee - T(7.0f)) * T(1.0f / 27.0f);
+            
+            return AudioSimd::select(magnitude < T(1.0f / 3.0f), magnitude * (magnitude - T(1.0f)),
+                                     AudioSimd::select(magnitude < T(2.0f / 3.0f), curved, T(-7.0f / 27.0f)));
+        }
+        else
+        {
+            // Integral de la onda triangular sobre u en [-2, 2): u - u|u| / 2, nula en los extremos
+            const auto shifted = x + T(1.0f);
+            const auto u = shifted - T(4.0f) * AudioSimd::floor(shifted * T(0.25f)) - T(2.0f);
+            return u - u * AudioSimd::abs(u) * T(0.5f);
+        }
+    }
+    
+    // Por debajo de esta distancia entre muestras la división pierde precisión
+    // en float y se usa f en el punto medio, cuyo error es O(dx^2)
+    static constexpr float antiderivativeTolerance = 1.0e-3f;
+    
+    template <ClipperType type, bool fast, typename T>
+    static T clipAntialiased(T x, T remainder, T previous, T previousRemainder) noexcept
+    {
+        const auto delta = x - previous;
+        const auto nearlyEqual = AudioSimd::abs(delta) < T(antiderivativeTolerance);
+        
+        auto difference = remainder - previousRemainder;
+        
+        if constexpr (type != ClipperType::kFoldback)
+            difference = (AudioSimd::abs(x) - AudioSimd::abs(previous)) + difference;
+        
+        return AudioSimd::select(nearlyEqual, clip<type, fast>((x + previous) * T(0.5f)),
+                                 difference / AudioSimd::select(nearlyEqual, T(1.0f), delta));
+    }
+    
+    // La muestra anterior de cada lane es la lane de al lado; la de la primera
+    // viene de previous. Sólo se guarda la muestra y su R se recalcula, así que
+    // cambiar de clipper a mitad de señal no deja un estado incoherente.
+    template <ClipperType type, bool fast>
+    static AudioSimd::Vec clipAntialiasedFrame(AudioSimd::Vec driven, float& previous, int numValid) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        float drivenLanes[Vec::width + 1];
+        float remainderLanes[Vec::width + 1];
+        const auto remainder = antiderivativeRemainder<type, fast>(driven);
+        
+        drivenLanes[0] = previous;
+        remainderLanes[0] = antiderivativeRemainder<type, fast>(previous);
+        driven.store(drivenLanes + 1);
+        remainder.store(remainderLanes + 1);
+        previous = drivenLanes[numValid];
+        
+        return clipAntialiased<type, fast>(driven, remainder, Vec::load(drivenLanes), Vec::load(remainderLanes));
+    }
+    
+    template <ClipperType type, bool fast>
+    float clipSample(float driven, int channel) noexcept
+    {
+        if (!antialiasing || !juce::isPositiveAndBelow(channel, static_cast<int>(previousDriven.size())))
+            return clip<type, fast>(driven);
+        
+        auto& previous = previousDriven[static_cast<size_t>(channel)];
+        const auto clipped = clipAntialiased<type, fast>(driven, antiderivativeRemainder<type, fast>(driven),
+                                                         previous, antiderivativeRemainder<type, fast>(previous));
+        previous = driven;
+        return clipped;
+    }
+    
+    // Las rampas corren a la frecuencia a la que trabaja el clipper
+    void prepareParameters() noexcept
+    {
+        const double processingRate = preparedSpec.sampleRate * oversampler.getFactor();
+        
+        for (auto* parameter : { &drive, &mix, &outputGain })
+            parameter->prepare(processingRate);
+    }
+    
+    float sampleRate = 44100.0f;
+    AudioParameterSmoother drive { 1.0f, AudioParameterSmoother::Curve::kMultiplicative };
+    AudioParameterSmoother mix { 1.0f };
+    AudioParameterSmoother outputGain { 0.5f };
+    ClipperType clipperType = ClipperType::kSoft;
+    bool fastMath = false;
+    bool antialiasing = false;
+    std::vector<float> previousDriven; // última muestra con drive de cada canal, para el ADAA
+    
+    AudioOversampler oversampler;
+    int oversamplingFactor = 1;
+    AudioOversampler::Quality oversamplingQuality = AudioOversampler::Quality::kStandard;
+    juce::dsp::ProcessSpec preparedSpec { 44100.0, 512, 2 };
+};
+
+//==============================================================================
+// AudioBitCrusher - Reducción de bits y sample rate
+//==============================================================================
+class AudioBitCrusher
+{
+public:
+    AudioBitCrusher() = default;
+    ~AudioBitCrusher() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        phase = 0.0f;
+        heldSamples.assign(spec.numChannels, 0.0f);
+        preparedSpec = spec;
+        oversampler.prepare(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize),
+                            oversamplingFactor, oversamplingQuality);
+        prepareParameters();
+    }
+    
+    template <typename SampleType>
+    SampleType processSample(SampleType input)
+    {
+        const auto currentSteps = steps.nextSample();
+        const auto currentMix = mix.nextSample();
+        
+        // Reducción de sample rate
+        phase += crushRate / sampleRate;
+        
+        if (phase >= 1.0f)
+        {
+            phase -= 1.0f;
+            lastOutput = input;
+            
+            // Reducción de bits
+            if (currentSteps < fullResolutionSteps)
+                lastOutput = std::floor(lastOutput * currentSteps) / currentSteps;
+        }
+        
+        // Mix
+        return input + (lastOutput - input) * currentMix;
+    }
+    
+    void reset()
+    {
+        phase = 0.0f;
+        lastOutput = 0.0f;
+        std::fill(heldSamples.begin(), heldSamples.end(), 0.0f);
+        oversampler.reset();
+    }
+    
+    /**
+     * Proceso por bloques. El reloj de muestreo es común a todos los canales
+     * (avanza una vez por muestra) y cada canal retiene su propio valor. La
+     * retención es recursiva y queda escalar; la mezcla es SIMD. Con
+     * sobremuestreo el reloj de captura corre a la frecuencia alta y los
+     * escalones salen filtrados por la bajada.
+     */
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        jassert(context.getOutputBlock().getNumChannels() <= heldSamples.size()); // prepare() con menos canales
+        
+        if (oversampler.isActive())
+        {
+            processContextOversampled(context, oversampler, [this](const auto& upContext)
+            {
+                processContextInFrames(upContext, makeFrameKernel());
+            });
+            
+            return;
+        }
+        
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain, que trabaja a la frecuencia base
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        jassert(!oversampler.isActive());
+        
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        const float processingRate = sampleRate * static_cast<float>(oversampler.getFactor());
+        
+        return [this, phaseIncrement = crushRate / processingRate](Vec* frame, int numChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            const auto mixV = mix.nextFrame(numValid);
+            
+            alignas(32) float stepLanes[Vec::width];
+            steps.nextFrame(numValid).store(stepLanes);
+            
+            // Instantes de captura, comunes a todos los canales
+            bool captures[Vec::width] = {};
+            
+            for (int i = 0; i < numValid; ++i)
+            {
+                phase += phaseIncrement;
+                captures[i] = phase >= 1.0f;
+                
+                if (captures[i])
+                    phase -= 1.0f;
+            }
+            
+            const int heldChannels = juce::jmin(numChannels, static_cast<int>(heldSamples.size()));
+            
+            for (int ch = 0; ch < heldChannels; ++ch)
+            {
+                alignas(32) float lanes[Vec::width];
+                frame[ch].store(lanes);
+                
+                auto& value = heldSamples[static_cast<size_t>(ch)];
+                
+                for (int i = 0; i < Vec::width; ++i)
+                {
+                    if (captures[i])
+                        value = stepLanes[i] < fullResolutionSteps ? std::floor(lanes[i] * stepLanes[i]) / stepLanes[i] : lanes[i];
+                    
+                    lanes[i] = value;
+                }
+                
+                const auto dry = frame[ch];
+                frame[ch] = dry + (Vec::load(lanes) - dry) * mixV;
+            }
+        };
+    }
+    
+    void setCrushRate(float newRate)
+    {
+        crushRate = juce::jlimit(100.0f, sampleRate, newRate);
+    }
+    
+    // Los escalones (2^bits) y la mezcla van en rampa; la rampa de escalones
+    // es multiplicativa, así que la profundidad en bits cambia linealmente
+    void setBitDepth(float newDepth)
+    {
+        steps.setTargetValue(std::exp2(juce::jlimit(1.0f, 16.0f, newDepth)));
+    }
+    
+    void setMix(float newMix)
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+    
+    // Sobremuestreo de process(), como en AudioDistortion: fuera del hilo de
+    // audio, con el callback detenido
+    void setOversampling(int factor, AudioOversampler::Quality quality)
+    {
+        oversamplingFactor = factor;
+        oversamplingQuality = quality;
+        oversampler.prepare(static_cast<int>(preparedSpec.numChannels), static_cast<int>(preparedSpec.maximumBlockSize),
+                            oversamplingFactor, oversamplingQuality);
+        prepareParameters();
+    }
+    
+    int getOversamplingFactor() const noexcept { return oversamplingFactor; }
+    
+    int getLatencySamples() const noexcept
+    {
+        return oversampler.isActive() ? oversampler.getLatencySamples() : 0;
+    }
+
+private:
+    void prepareParameters() noexcept
+    {
+        const double processingRate = preparedSpec.sampleRate * oversampler.getFactor();
+        steps.prepare(processingRate);
+        mix.prepare(processingRate);
+    }
+    
+    // A 16 bits (2^16 escalones) no se cuantiza
+    static constexpr float fullResolutionSteps = 65536.0f;
+    
+    float sampleRate = 44100.0f;
+    float crushRate = 44100.0f;
+    AudioParameterSmoother steps { fullResolutionSteps, AudioParameterSmoother::Curve::kMultiplicative };
+    AudioParameterSmoother mix { 1.0f };
+    float phase = 0.0f;
+    float lastOutput = 0.0f;
+    std::vector<float> heldSamples; // un valor retenido por canal en process()
+    
+    AudioOversampler oversampler;
+    int oversamplingFactor = 1;
+    AudioOversampler::Quality oversamplingQuality = AudioOversampler::Quality::kStandard;
+    juce::dsp::ProcessSpec preparedSpec { 44100.0, 512, 2 };
+};
+
+//==============================================================================
+// AudioEqualizer - Ecualizador paramétrico de hasta 8 bandas
+//==============================================================================
+/**
+ * Bandas biquad (RBJ) en forma directa transpuesta II, en serie. Las bandas
+ * ocupan las lanes de un Vec (8 con AVX, 4 con SSE/NEON) y se evalúan en
+ * diagonal: en cada paso la lane k procesa la muestra n - k con la salida que
+ * la lane k - 1 dejó en el paso anterior, así que todas las bandas de un
+ * grupo avanzan con una sola operación vectorial y sin latencia. Llenar y
+ * vaciar la diagonal cuesta bandas - 1 pasos por tramo procesado.
+ *
+ * Los setters sólo guardan los parámetros de la banda; los coeficientes se
+ * recalculan una vez, en el hilo de audio al empezar el siguiente bloque, y
+ * nunca por muestra. Cada banda tiene su lane fija: una desactivada queda
+ * como identidad y las demás conservan su estado.
+ */
+class AudioEqualizer
+{
+public:
+    enum class BandType
+    {
+        kBell,
+        kLowShelf,
+        kHighShelf,
+        kLowCut,
+        kHighCut,
+        kNotch
+    };
+    
+    static constexpr int maxBands = 8;
+    
+    AudioEqualizer() = default;
+    ~AudioEqualizer() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        coefficientsDirty = true;
+        reset();
+    }
+    
+    void reset()
+    {
+        state1.fill(0.0f);
+        state2.fill(0.0f);
+    }
+    
+    // Las bandas en orden, muestra a muestra; los mismos coeficientes y estado que process()
+    template <typename SampleType>
+    SampleType processSample(SampleType input, int channel)
+    {
+        updateCoefficientsIfNeeded();
+        auto sample = static_cast<float>(input);
+        
+        for (int band = 0; band < maxBands; ++band)
+        {
+            const auto index = static_cast<size_t>(band);
+            auto& s1 = state1[static_cast<size_t>(channel * maxBands + band)];
+            auto& s2 = state2[static_cast<size_t>(channel * maxBands + band)];
+            const auto y = b0[index] * sample + s1;
+            
+            s1 = b1[index] * sample - a1[index] * y + s2;
+            s2 = b2[index] * sample - a2[index] * y;
+            sample = y;
+        }
+        
+        return static_cast<SampleType>(sample);
+    }
+    
+    // Proceso por bloques: cada canal recorre el bloque entero una vez por
+    // grupo de Vec::width bandas, con un solo llenado y vaciado de la diagonal
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom(inputBlock);
+        
+        if (context.isBypassed)
+            return;
+        
+        updateCoefficientsIfNeeded();
+        
+        const auto numSamples = static_cast<int>(outputBlock.getNumSamples());
+        const auto numChannels = juce::jmin(static_cast<int>(outputBlock.getNumChannels()), maxFrameChannels);
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int group = 0; group < numGroups; ++group)
+                processGroup(group, ch, outputBlock.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+    }
+    
+    // Para AudioProcessorChain: cada trama paga su propio llenado y vaciado
+    // de la diagonal, así que fuera de una cadena es mejor process()
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        updateCoefficientsIfNeeded();
+        
+        return [this](Vec* frame, int numChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            alignas(32) float samples[Vec::width];
+            
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                frame[ch].store(samples);
+                
+                for (int group = 0; group < numGroups; ++group)
+                    processGroup(group, ch, samples, numValid);
+                
+                frame[ch] = Vec::load(samples);
+            }
+        };
+    }
+    
+    void setBand(int band, BandType type, float frequency, float gainDb, float q)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        auto& parameters = bands[static_cast<size_t>(band)];
+        
+        parameters.type = type;
+        parameters.frequency = juce::jlimit(20.0f, 20000.0f, frequency);
+        parameters.gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
+        parameters.q = juce::jlimit(0.1f, 18.0f, q);
+        parameters.enabled = true;
+        coefficientsDirty = true;
+    }
+    
+    void setBandEnabled(int band, bool shouldBeEnabled)
+    {
+        jassert(juce::isPositiveAndBelow(band, maxBands));
+        bands[static_cast<size_t>(band)].enabled = shouldBeEnabled;
+        coefficientsDirty = true;
+    }
+    
+    bool isBandEnabled(int band) const noexcept
+    {
+        return bands[static_cast<size_t>(band)].enabled;
+    }
+
+private:
+    struct Band
+    {
+        BandType type = BandType::kBell;
+        float frequency = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 0.707f;
+        bool enabled = false;
+    };
+    
+    static_assert(maxBands % AudioSimd::Vec::width == 0, "Los grupos de bandas llenan el Vec");
+    
+    /**
+     * Pasa samples por las bandas del grupo, in-place. En el paso t la lane k
+     * procesa la muestra t - k; en los primeros y últimos pasos las lanes sin
+     * muestra que procesar no tocan su estado. La muestra t - k sólo se
+     * escribe cuando ya se ha leído la t, así que el tramo puede ser in-place.
+     */
+    void processGroup(int group, int channel, float* samples, int numSamples) noexcept
+    {
+        using AudioSimd::Vec;
+        
+        const int stages = groupStages[static_cast<size_t>(group)];
+        
+        if (stages == 0 || numSamples == 0)
+            return;
+        
+        alignas(32) static constexpr float laneIndices[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+        static_assert(Vec::width <= 8, "laneIndices cubre hasta 8 lanes");
+        
+        const int offset = group * Vec::width;
+        const auto lane = Vec::load(laneIndices);
+        const auto coefficientB0 = Vec::load(b0.data() + offset);
+        const auto coefficientB1 = Vec::load(b1.data() + offset);
+        const auto coefficientB2 = Vec::load(b2.data() + offset);
+        const auto coefficientA1 = Vec::load(a1.data() + offset);
+        const auto coefficientA2 = Vec::load(a2.data() + offset);
+        
+        auto* groupState1 = state1.data() + channel * maxBands + offset;
+        auto* groupState2 = state2.data() + channel * maxBands + offset;
+        auto s1 = Vec::load(groupState1);
+        auto s2 = Vec::load(groupState2);
+        
+        Vec previous(0.0f);
+        alignas(32) float lanes[Vec::width];
+        const int numSteps = numSamples + stages - 1;
+        
+        for (int t = 0; t < numSteps; ++t)
+        {
+            const auto x = AudioSimd::shiftLanesUp(previous, t < numSamples ? samples[t] : 0.0f);
+            const auto y = coefficientB0 * x + s1;
+            const auto next1 = coefficientB1 * x - coefficientA1 * y + s2;
+            const auto next2 = coefficientB2 * x - coefficientA2 * y;
+            
+            if (t >= stages - 1 && t < numSamples)
+            {
+                s1 = next1;
+                s2 = next2;
+            }
+            else
+            {
+                const auto active = lane < Vec(static_cast<float>(t + 1)) && lane > Vec(static_cast<float>(t - numSamples));
+                s1 = AudioSimd::select(active, next1, s1);
+                s2 = AudioSimd::select(active, next2, s2);
+            }
+            
+            previous = y;
+            
+            if (t >= stages - 1)
+            {
+                y.store(lanes);
+                samples[t - stages + 1] = lanes[stages - 1];
+            }
+        }
+        
+        s1.store(groupState1);
+        s2.store(groupState2);
+    }
+    
+    void updateCoefficientsIfNeeded() noexcept
+    {
+        if (!coefficientsDirty)
+            return;
+        
+        coefficientsDirty = false;
+        numGroups = 0;
+        groupStages.fill(0);
+        
+        for (int band = 0; band < maxBands; ++band)
+        {
+            const auto index = static_cast<size_t>(band);
+            const auto& parameters = bands[index];
+            
+            if (!parameters.enabled)
+            {
+                // Identidad, y al volver a activarla empieza sin restos
+                b0[index] = 1.0f;
+                b1[index] = b2[index] = a1[index] = a2[index] = 0.0f;
+                
+                for (int ch = 0; ch < maxFrameChannels; ++ch)
+                    state1[static_cast<size_t>(ch * maxBands + band)] = state2[static_cast<size_t>(ch * maxBands + band)] = 0.0f;
+                
+                continue;
+            }
+            
+            calculateCoefficients(parameters, index);
+            
+            const int group = band / AudioSimd::Vec::width;
+            groupStages[static_cast<size_t>(group)] = band - group * AudioSimd::Vec::width + 1;
+            numGroups = group + 1;
+        }
+    }
+    
+    // Audio EQ Cookbook (RBJ), normalizado por a0
+    void calculateCoefficients(const Band& parameters, size_t index) noexcept
+    {
+        const double frequency = juce::jmin(static_cast<double>(parameters.frequency), 0.49 * sampleRate);
+        const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const double cosOmega = std::cos(omega);
+        const double alpha = std::sin(omega) / (2.0 * parameters.q);
+        const double amplitude = std::pow(10.0, parameters.gainDb / 40.0);
+        const double shelfAlpha = 2.0 * std::sqrt(amplitude) * alpha;
+        
+        double c[6] = {}; // b0, b1, b2, a0, a1, a2
+        
+        switch (parameters.type)
+        {
+            case BandType::kBell:
+                c[0] = 1.0 + alpha * amplitude;  c[1] = -2.0 * cosOmega;  c[2] = 1.0 - alpha * amplitude;
+                c[3] = 1.0 + alpha / amplitude;  c[4] = -2.0 * cosOmega;  c[5] = 1.0 - alpha / amplitude;
+                break;
+            
+            case BandType::kLowShelf:
+                c[0] = amplitude * ((amplitude + 1.0) - (amplitude - 1.0) * cosOmega + shelfAlpha);
+                c[1] = 2.0 * amplitude * ((amplitude - 1.0) - (amplitude + 1.0) * cosOmega);
+                c[2] = amplitude * ((amplitude + 1.0) - (amplitude - 1.0) * cosOmega - shelfAlpha);
+                c[3] = (amplitude + 1.0) + (amplitude - 1.0) * cosOmega + shelfAlpha;
+                c[4] = -2.0 * ((amplitude - 1.0) + (amplitude + 1.0) * cosOmega);
+                c[5] = (amplitude + 1.0) + (amplitude - 1.0) * cosOmega - shelfAlpha;
+                break;
+            
+            case BandType::kHighShelf:
+                c[0] = amplitude * ((amplitude + 1.0) + (amplitude - 1.0) * cosOmega + shelfAlpha);
+                c[1] = -2.0 * amplitude * ((amplitude - 1.0) + (amplitude + 1.0) * cosOmega);
+                c[2] = amplitude * ((amplitude + 1.0) + (amplitude - 1.0) * cosOmega - shelfAlpha);
+                c[3] = (amplitude + 1.0) - (amplitude - 1.0) * cosOmega + shelfAlpha;
+                c[4] = 2.0 * ((amplitude - 1.0) - (amplitude + 1.0) * cosOmega);
+                c[5] = (amplitude + 1.0) - (amplitude - 1.0) * cosOmega - shelfAlpha;
+                break;
+            
+            case BandType::kLowCut:
+                c[0] = (1.0 + cosOmega) * 0.5;  c[1] = -(1.0 + cosOmega);  c[2] = (1.0 + cosOmega) * 0.5;
+                c[3] = 1.0 + alpha;             c[4] = -2.0 * cosOmega;    c[5] = 1.0 - alpha;
+                break;
+            
+            case BandType::kHighCut:
+                c[0] = (1.0 - cosOmega) * 0.5;  c[1] = 1.0 - cosOmega;     c[2] = (1.0 - cosOmega) * 0.5;
+                c[3] = 1.0 + alpha;             c[4] = -2.0 * cosOmega;    c[5] = 1.0 - alpha;
+                break;
+            
+            case BandType::kNotch:
+                c[0] = 1.0;                     c[1] = -2.0 * cosOmega;    c[2] = 1.0;
+                c[3] = 1.0 + alpha;             c[4] = -2.0 * cosOmega;    c[5] = 1.0 - alpha;
+                break;
+        }
+        
+        b0[index] = static_cast<float>(c[0] / c[3]);
+        b1[index] = static_cast<float>(c[1] / c[3]);
+        b2[index] = static_cast<float>(c[2] / c[3]);
+        a1[index] = static_cast<float>(c[4] / c[3]);
+        a2[index] = static_cast<float>(c[5] / c[3]);
+    }
+    
+    float sampleRate = 44100.0f;
+    std::array<Band, maxBands> bands;
+    bool coefficientsDirty = true;
+    
+    // Coeficientes por banda, en grupos de Vec::width (una lane por banda)
+    alignas(32) std::array<float, maxBands> b0 {};
+    alignas(32) std::array<float, maxBands> b1 {};
+    alignas(32) std::array<float, maxBands> b2 {};
+    alignas(32) std::array<float, maxBands> a1 {};
+    alignas(32) std::array<float, maxBands> a2 {};
+    
+    // Bandas hasta la última activa de cada grupo; los grupos vacíos del final no se recorren
+    std::array<int, maxBands> groupStages {};
+    int numGroups = 0;
+    
+    // Estado de cada canal y banda: [canal * maxBands + banda]
+    alignas(32) std::array<float, maxFrameChannels * maxBands> state1 {};
+    alignas(32) std::array<float, maxFrameChannels * maxBands> state2 {};
+};
+
+/**
+ * @class AudioFdnReverb
+ * @brief Reverb algorítmica de red de retardos realimentada (FDN) de 8 o 16 líneas
+ *
+ * Pensada para envíos de canal: decenas de instancias cuestan menos que una
+ * sola convolución. Cada muestra lee la salida de todas las líneas, las pasa
+ * por su filtro de absorción, las mezcla con una matriz ortogonal y las
+ * vuelve a escribir con la entrada sumada. Las líneas van en lanes de
+ * AudioSimd::Vec: filtros, mezcla, inyección de la entrada y tomas de salida
+ * son una pasada vectorial; sólo la lectura y escritura de los retardos son
+ * escalares (cada línea tiene su longitud).
+ *
+ * La matriz no se multiplica entera: es una reflexión de Householder
+ * (x - 2/N * suma(x)), y con 16 líneas además una mariposa de Hadamard entre
+ * las dos mitades. Las sumas entre líneas siguen un árbol fijo
+ * (AudioSimd::sumLanes), así que el resultado es el mismo con cualquier ancho
+ * de vector.
+ *
+ * El filtro de cada línea es un polo que da la ganancia justa para el tiempo
+ * de caída en graves y uno más corto en agudos según el amortiguamiento. Toda
+ * la memoria de retardo es un único bloque reservado en prepare() para el
+ * tamaño de sala máximo. Estéreo o mono; los canales a partir del tercero
+ * pasan sin tocar.
+ */
+template <int numLines>
+class AudioFdnReverb
+{
+public:
+    static_assert(numLines == 8 || numLines == 16, "AudioFdnReverb admite 8 o 16 líneas");
+    static_assert(numLines % AudioSimd::Vec::width == 0, "Las líneas deben llenar Vec completos");
+    
+    AudioFdnReverb() = default;
+    ~AudioFdnReverb() = default;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = static_cast<float>(spec.sampleRate);
+        numChannels = juce::jmin(static_cast<int>(spec.numChannels), 2);
+        mix.prepare(spec.sampleRate);
+        
+        // Cada línea con sitio para su longitud con el tamaño de sala máximo
+        int total = 0;
+        
+        for (int line = 0; line < numLines; ++line)
+        {
+            lineStarts[static_cast<size_t>(line)] = total;
+            total += getLineLength(line, 1.0f);
+        }
+        
+        delayMemory.assign(static_cast<size_t>(total), 0.0f);
+        appliedRoomSize = -1.0f;
+        updateIfNeeded();
+        reset();
+    }
+    
+    void reset()
+    {
+        std::fill(delayMemory.begin(), delayMemory.end(), 0.0f);
+        linePositions.fill(0);
+        filterStates.fill(0.0f);
+    }
+    
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    // Función de trama (frame, numChannels, numValid), in-place
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
+        
+        updateIfNeeded();
+        
+        return [this](Vec* frame, int frameChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            const int channels = juce::jmin(frameChannels, numChannels);
+            
+            if (channels == 0)
+                return;
+            
+            alignas(32) float left[Vec::width];
+            alignas(32) float right[Vec::width];
+            frame[0].store(left);
+            frame[channels - 1].store(right);
+            
+            for (int i = 0; i < numValid; ++i)
+                tick(left[i], right[i]);
+            
+            const auto amount = mix.nextFrame(numValid);
+            
+            frame[0] = frame[0] + amount * (Vec::load(left) - frame[0]);
+            
+            if (channels > 1)
+                frame[1] = frame[1] + amount * (Vec::load(right) - frame[1]);
+        };
+    }
+    
+    // Tiempo de caída a -60 dB en graves, en segundos
+    void setDecayTime(float newDecaySeconds)
+    {
+        decaySeconds = juce::jlimit(0.1f, 30.0f, newDecaySeconds);
+        coefficientsDirty = true;
+    }
+    
+    // 0: los agudos caen como los graves; 1: diez veces más rápido
+    void setDamping(float newDamping)
+    {
+        damping = juce::jlimit(0.0f, 1.0f, newDamping);
+        coefficientsDirty = true;
+    }
+    
+    // Escala las longitudes de las líneas (0.3x a 1x). Cambiarla recoloca
+    // las líneas al vuelo y puede oírse: no está pensada para automatizar.
+    void setRoomSize(float newRoomSize)
+    {
+        roomSize = juce::jlimit(0.0f, 1.0f, newRoomSize);
+    }
+    
+    void setMix(float newMix)
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+
+private:
+    static constexpr int numGroups = numLines / AudioSimd::Vec::width;
+    
+    // Longitud de cada línea con el tamaño de sala máximo, en ms. Repartidas
+    // entre 30 y 87 ms sin razones simples entre ellas; con 8 líneas se
+    // toma una de cada dos.
+    static float getBaseLineMs(int line) noexcept
+    {
+        static constexpr float lengthsMs[] = { 29.7f, 31.9f, 35.3f, 37.1f, 41.1f, 43.7f, 47.3f, 50.9f,
+                                               53.9f, 58.1f, 61.7f, 66.1f, 70.9f, 75.7f, 80.3f, 86.9f };
+        return lengthsMs[line * (16 / numLines)];
+    }
+    
+    // Muestras de retardo de una línea, siempre impar
+    int getLineLength(int line, float size) const noexcept
+    {
+        const auto scale = 0.3f + 0.7f * size;
+        return static_cast<int>(getBaseLineMs(line) * 0.001f * sampleRate * scale) | 1;
+    }
+    
+    // Sumas entre líneas en el orden de AudioSimd::sumLanes, para que no
+    // dependan del ancho de vector
+    static float sumLines(const AudioSimd::Vec* lines) noexcept
+    {
+        AudioSimd::Vec partial[numGroups];
+        
+        for (int group = 0; group < numGroups; ++group)
+            partial[group] = lines[group];
+        
+        for (int half = numGroups / 2; half > 0; half /= 2)
+            for (int group = 0; group < half; ++group)
+                partial[group] = partial[group] + partial[group + half];
+        
+        return AudioSimd::sumLanes(partial[0]);
+    }
+    
+    // En el hilo de audio antes de cada bloque: longitudes y filtros de las líneas
+    void updateIfNeeded() noexcept
+    {
+        if (roomSize != appliedRoomSize)
+        {
+            appliedRoomSize = roomSize;
+            
+            for (int line = 0; line < numLines; ++line)
+            {
+                const auto index = static_cast<size_t>(line);
+                lineLengths[index] = getLineLength(line, roomSize);
+                linePositions[index] %= lineLengths[index];
+            }
+            
+            coefficientsDirty = true;
+        }
+        
+        if (!coefficientsDirty)
+            return;
+        
+        coefficientsDirty = false;
+        
+        // Un polo por línea: ganancia g a 0 Hz para la caída en graves y
+        // g * (1 - a) / (1 + a) en Nyquist para la de agudos
+        const auto highDecaySeconds = decaySeconds * (1.0f - 0.9f * damping);
+        
+        for (int line = 0; line < numLines; ++line)
+        {
+            const auto index = static_cast<size_t>(line);
+            const auto length = static_cast<float>(lineLengths[index]);
+            const auto lowGain = std::pow(10.0f, -3.0f * length / (decaySeconds * sampleRate));
+            const auto highGain = std::pow(10.0f, -3.0f * length / (highDecaySeconds * sampleRate));
+            const auto ratio = highGain / lowGain;
+            const auto pole = (1.0f - ratio) / (1.0f + ratio);
+            
+            filterPoles[index] = pole;
+            filterGains[index] = lowGain * (1.0f - pole);
+            
+            // Signos ortogonales entre sí para entrada y salida: izquierda y derecha decorreladas
+            const auto scale = 1.0f / std::sqrt(static_cast<float>(numLines));
+            inputLeft[index] = (line % 4 == 0 || line % 4 == 3) ? scale : -scale;
+            inputRight[index] = (line % 4 < 2) ? scale : -scale;
+            outputLeft[index] = (line % 2 == 0) ? scale : -scale;
+            outputRight[index] = ((line / 2) % 2 == 0) ? scale : -scale;
+        }
+    }
+    
+    // Una muestra de la red; left y right pasan de entrada a salida húmeda
+    void tick(float& left, float& right) noexcept
+    {
+        using AudioSimd::Vec;
+        constexpr int width = Vec::width;
+        
+        alignas(32) float lineSamples[numLines];
+        
+        for (int line = 0; line < numLines; ++line)
+            lineSamples[line] = delayMemory[static_cast<size_t>(lineStarts[static_cast<size_t>(line)] + linePositions[static_cast<size_t>(line)])];
+        
+        // Absorción: y = g (1 - a) x + a y[-1]
+        Vec lines[numGroups];
+        
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int offset = group * width;
+            const auto filtered = Vec::load(lineSamples + offset) * Vec::load(filterGains.data() + offset)
+                                + Vec::load(filterStates.data() + offset) * Vec::load(filterPoles.data() + offset);
+            filtered.store(filterStates.data() + offset);
+            lines[group] = filtered;
+        }
+        
+        Vec tapsLeft[numGroups];
+        Vec tapsRight[numGroups];
+        
+        for (int group = 0; group < numGroups; ++group)
+        {
+            tapsLeft[group] = lines[group] * Vec::load(outputLeft.data() + group * width);
+            tapsRight[group] = lines[group] * Vec::load(outputRight.data() + group * width);
+        }
+        
+        const auto inputL = Vec(left);
+        const auto inputR = Vec(right);
+        left = sumLines(tapsLeft);
+        right = sumLines(tapsRight);
+        
+        // Householder: x - 2/N * suma(x)
+        const auto reflection = Vec(sumLines(lines) * (2.0f / static_cast<float>(numLines)));
+        
+        for (int group = 0; group < numGroups; ++group)
+            lines[group] = lines[group] - reflection;
+        
+        // Con 16 líneas, Hadamard 2x2 entre la línea i y la i + 8
+        if constexpr (numLines == 16)
+        {
+            const auto norm = Vec(0.70710678f);
+            
+            for (int group = 0; group < numGroups / 2; ++group)
+            {
+                const auto a = lines[group];
+                const auto b = lines[group + numGroups / 2];
+                lines[group] = (a + b) * norm;
+                lines[group + numGroups / 2] = (a - b) * norm;
+            }
+        }
+        
+        // Entrada, más un resto minúsculo que mantiene las líneas lejos de
+        // los números desnormalizados cuando la cola se apaga
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int offset = group * width;
+            const auto injected = lines[group] + inputL * Vec::load(inputLeft.data() + offset)
+                                               + inputR * Vec::load(inputRight.data() + offset) + Vec(antiDenormal);
+            injected.store(lineSamples + offset);
+        }
+        
+        for (int line = 0; line < numLines; ++line)
+        {
+            const auto index = static_cast<size_t>(line);
+            auto& position = linePositions[index];
+            delayMemory[static_cast<size_t>(lineStarts[index] + position)] = lineSamples[line];
+            
+            if (++position == lineLengths[index])
+                position = 0;
+        }
+    }
+    
+    static constexpr float antiDenormal = 1.0e-20f;
+    
+    float sampleRate = 44100.0f;
+    int numChannels = 2;
+    
+    float decaySeconds = 2.0f;
+    float damping = 0.5f;
+    float roomSize = 0.7f;
+    float appliedRoomSize = -1.0f;
+    bool coefficientsDirty = true;
+    AudioParameterSmoother mix { 0.3f };
+    
+    // Todas las líneas en un bloque contiguo: la línea i ocupa
+    // [lineStarts[i], lineStarts[i] + lineLengths[i])
+    std::vector<float> delayMemory;
+    std::array<int, numLines> lineStarts {};
+    std::array<int, numLines> lineLengths {};
+    std::array<int, numLines> linePositions {};
+    
+    // Por línea, en grupos de Vec::width (una lane por línea)
+    alignas(32) std::array<float, numLines> filterGains {};
+    alignas(32) std::array<float, numLines> filterPoles {};
+    alignas(32) std::array<float, numLines> filterStates {};
+    alignas(32) std::array<float, numLines> inputLeft {};
+    alignas(32) std::array<float, numLines> inputRight {};
+    alignas(32) std::array<float, numLines> outputLeft {};
+    alignas(32) std::array<float, numLines> outputRight {};
+};
+
+/**
+ * @class AudioDelayLine
+ * @brief Línea de retardo multicanal con lectura fraccionaria por lanes
+ *
+ * Base de AudioDelay, AudioChorus y AudioFlanger. Cada canal es un anillo de
+ * tamaño potencia de dos: las posiciones se envuelven con una máscara, nunca
+ * con módulo. Tras el anillo hay una copia de sus primeras muestras, así que
+ * una trama entera o las cuatro tomas de la interpolación se leen contiguas
+ * aunque crucen el final.
+ *
+ * La lectura fraccionaria acepta un retardo distinto por lane (el de cada
+ * muestra de la trama) e interpola con Lagrange cúbica; los coeficientes se
+ * calculan en vector y sólo la recogida de las tomas es escalar.
+ *
+ * Uso por trama: write() de cada canal, lecturas y advance() al final. Si
+ * la escritura depende de la lectura (realimentación), se lee antes de
+ * escribir y el retardo no puede bajar de minFeedbackDelay.
+ */
+class AudioDelayLine
+{
+public:
+    // Retardo mínimo de readInterpolated(): las cuatro tomas ya escritas
+    static constexpr float minInterpolatedDelay = 2.0f;
     
-    AudioCompressor() = default;
-    ~AudioCompressor() = default;
+    // Retardo mínimo si se lee antes de escribir la trama: las tomas caen en
+    // tramas anteriores con cualquier ancho de vector (hasta 8 lanes)
+    static constexpr float minFeedbackDelay = 11.0f;
     
-    void prepare(const juce::dsp::ProcessSpec& spec)
+    // Fuera del hilo de audio
+    void prepare(int newNumChannels, int maxDelaySamples)
     {
-        sampleRate = static_cast<float>(spec.sampleRate);
-        reset();
+        numChannels = juce::jmax(1, newNumChannels);
+        ringSize = juce::nextPowerOfTwo(juce::jmax(1, maxDelaySamples) + AudioSimd::Vec::width + 4);
+        ringStride = ringSize + mirrorSize;
+        buffer.assign(static_cast<size_t>(numChannels * ringStride), 0.0f);
+        position = 0;
     }
     
     void reset()
     {
-        envelope = 0.0f;
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        position = 0;
     }
     
-    template <typename SampleType>
-    SampleType processSample(SampleType input, int channel)
+    int getNumChannels() const noexcept { return numChannels; }
+    
+    // Mayor retardo que admite la lectura, en muestras
+    int getMaxDelay() const noexcept { return ringSize - AudioSimd::Vec::width - 4; }
+    
+    // Guarda las numValid muestras de la trama en la posición actual
+    void write(int channel, AudioSimd::Vec samples, int numValid) noexcept
     {
-        // Aplicar gain de entrada
-        auto sample = input * inputGain;
-        
-        // Detector de envolvente
-        auto inputLevel = std::abs(sample);
-        auto inputLevelDB = juce::Decibels::gainToDecibels(inputLevel + 0.00001f);
-        
-        // Actualizar envolvente
-        if (inputLevelDB > envelope)
-            envelope += (inputLevelDB - envelope) * alphaAttack;
-        else
-            envelope += (inputLevelDB - envelope) * alphaRelease;
+        alignas(32) float lanes[AudioSimd::Vec::width];
+        samples.store(lanes);
         
-        // Calcular reducción de ganancia
-        SampleType gainReduction = 0.0f;
+        auto* ring = getRing(channel);
         
-        if (envelope > threshold)
+        for (int i = 0; i < numValid; ++i)
         {
-            auto overThreshold = envelope - threshold;
+            const int index = (position + i) & (ringSize - 1);
+            ring[index] = lanes[i];
             
-            // Aplicar knee suave
-            if (knee > 0.0f && overThreshold < knee)
-            {
-                auto kneeRatio = overThreshold / knee;
-                gainReduction = overThreshold * kneeRatio * (1.0f - 1.0f / ratio) * 0.5f;
-            }
-            else
-            {
-                gainReduction = overThreshold * (1.0f - 1.0f / ratio);
-            }
+            if (index < mirrorSize)
+                ring[index + ringSize] = lanes[i];
         }
+    }
+    
+    // Retardo entero común a toda la trama: una carga contigua
+    AudioSimd::Vec read(int channel, int delay) const noexcept
+    {
+        return AudioSimd::Vec::load(getRing(channel) + ((position - delay) & (ringSize - 1)));
+    }
+    
+    // Retardo fraccionario por lane, en muestras, entre minInterpolatedDelay
+    // y getMaxDelay()
+    AudioSimd::Vec readInterpolated(int channel, AudioSimd::Vec delays) const noexcept
+    {
+        using AudioSimd::Vec;
         
-        // Convertir a ganancia lineal
-        auto gainLinear = juce::Decibels::decibelsToGain(-gainReduction);
+        alignas(32) static constexpr float laneIndices[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+        static_assert(Vec::width <= 8, "laneIndices cubre hasta 8 lanes");
         
-        // Aplicar tipo de compresor
-        if (compressorType == CompressorType::kOpto)
-        {
-            // Opto es más suave y lento
-            gainLinear = std::pow(gainLinear, 0.8f);
-        }
+        // Respecto a la posición actual: números pequeños, sin perder fracción
+        const auto offsets = Vec::load(laneIndices) - delays;
+        const auto whole = AudioSimd::floor(offsets);
+        const auto t = offsets - whole;
         
-        // Aplicar compresión
-        auto compressed = sample * gainLinear;
+        alignas(32) float wholeLanes[Vec::width];
+        alignas(32) float taps[4][Vec::width];
+        whole.store(wholeLanes);
         
-        // Gain de salida
-        compressed *= outputGain;
+        const auto* ring = getRing(channel);
         
-        // Mix (wet/dry)
-        auto output = input + (compressed - input) * mix;
+        for (int i = 0; i < Vec::width; ++i)
+        {
+            const auto* x = ring + ((position + static_cast<int>(wholeLanes[i]) - 1) & (ringSize - 1));
+            taps[0][i] = x[0];
+            taps[1][i] = x[1];
+            taps[2][i] = x[2];
+            taps[3][i] = x[3];
+        }
         
-        // Almacenar reducción para metering
-        if (channel == 0)
-            currentGainReduction = gainReduction;
+        // Lagrange de 4 puntos en -1, 0, 1, 2
+        const auto tPlus1 = t + 1.0f;
+        const auto tMinus1 = t - 1.0f;
+        const auto tMinus2 = t - 2.0f;
+        const auto c0 = t * tMinus1 * tMinus2 * -(1.0f / 6.0f);
+        const auto c1 = tPlus1 * tMinus1 * tMinus2 * 0.5f;
+        const auto c2 = tPlus1 * t * tMinus2 * -0.5f;
+        const auto c3 = tPlus1 * t * tMinus1 * (1.0f / 6.0f);
         
-        return output;
+        return Vec::load(taps[0]) * c0 + Vec::load(taps[1]) * c1
+             + Vec::load(taps[2]) * c2 + Vec::load(taps[3]) * c3;
     }
     
-    void setThreshold(float newThreshold)
+    void advance(int numValid) noexcept
     {
-        threshold = newThreshold;
+        position = (position + numValid) & (ringSize - 1);
     }
+
+private:
+    // Una trama o cuatro tomas leídas desde la última posición del anillo
+    static constexpr int mirrorSize = AudioSimd::Vec::width + 3;
     
-    void setRatio(float newRatio)
-    {
-        ratio = juce::jlimit(1.0f, 20.0f, newRatio);
-    }
+    float* getRing(int channel) noexcept { return buffer.data() + channel * ringStride; }
+    const float* getRing(int channel) const noexcept { return buffer.data() + channel * ringStride; }
     
-    void setAttack(float newAttack)
+    std::vector<float> buffer;
+    int numChannels = 0;
+    int ringSize = 0;
+    int ringStride = 0;
+    int position = 0;
+};
+
+/**
+ * @class AudioLfo
+ * @brief Oscilador senoidal de baja frecuencia calculado por tramas
+ *
+ * valuesAt() da el seno de las Vec::width muestras siguientes de una vez,
+ * con un desfase opcional en ciclos para voces o canales; advance() mueve
+ * la fase al final de la trama. La fase de cada muestra sale del número de
+ * muestras desde el último cambio de frecuencia, en double, y no de ir
+ * sumando incrementos: el resultado no depende del ancho de vector. El seno
+ * es un polinomio impar de grado 7 sobre el cuarto de ciclo plegado (error
+ * por debajo de 2e-4), en vector.
+ */
+class AudioLfo
+{
+public:
+    void prepare(double newSampleRate) noexcept
     {
-        attack = juce::jlimit(0.1f, 100.0f, newAttack);
-        alphaAttack = 1.0f - std::exp(-1.0f / (attack * 0.001f * sampleRate));
+        sampleRate = newSampleRate;
+        setRate(rateHz);
     }
     
-    void setRelease(float newRelease)
+    void reset(float initialPhase = 0.0f) noexcept
     {
-        release = juce::jlimit(10.0f, 1000.0f, newRelease);
-        alphaRelease = 1.0f - std::exp(-1.0f / (release * 0.001f * sampleRate));
+        startPhase = initialPhase - std::floor(initialPhase);
+        elapsedSamples = 0;
+        updateFramePhases();
     }
     
-    void setKnee(float newKnee)
+    // Fuera de process(): la fase sigue desde donde estaba
+    void setRate(float newRateHz) noexcept
     {
-        knee = juce::jlimit(0.0f, 12.0f, newKnee);
+        startPhase = getPhaseAt(elapsedSamples);
+        elapsedSamples = 0;
+        rateHz = newRateHz;
+        increment = rateHz / sampleRate;
+        updateFramePhases();
     }
     
-    void setInputGain(float newGain)
+    // Valores en [-1, 1] de las muestras de la trama, desfasados phaseOffset ciclos
+    AudioSimd::Vec valuesAt(float phaseOffset = 0.0f) const noexcept
     {
-        inputGain = juce::Decibels::decibelsToGain(newGain);
+        using AudioSimd::Vec;
+        
+        const auto phases = Vec::load(framePhases) + phaseOffset;
+        
+        // A [-0.5, 0.5) y plegado a [-0.25, 0.25]
+        auto t = phases - AudioSimd::floor(phases + 0.5f);
+        const auto half = AudioSimd::select(t < Vec(0.0f), Vec(-0.5f), Vec(0.5f));
+        t = AudioSimd::select(AudioSimd::abs(t) > Vec(0.25f), half - t, t);
+        
+        const auto x = t * 6.28318531f;
+        const auto x2 = x * x;
+        return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f))));
     }
     
-    void setOutputGain(float newGain)
+    void advance(int numValid) noexcept
     {
-        outputGain = juce::Decibels::decibelsToGain(newGain);
+        elapsedSamples += numValid;
+        updateFramePhases();
     }
-    
-    void setMix(float newMix)
+
+private:
+    double getPhaseAt(juce::int64 sample) const noexcept
     {
-        mix = juce::jlimit(0.0f, 1.0f, newMix);
+        const auto phase = startPhase + static_cast<double>(sample) * increment;
+        return phase - std::floor(phase);
     }
     
-    void setCompressorType(CompressorType newType)
+    void updateFramePhases() noexcept
     {
-        compressorType = newType;
+        for (int i = 0; i < AudioSimd::Vec::width; ++i)
+            framePhases[i] = static_cast<float>(getPhaseAt(elapsedSamples + i));
     }
     
-    float getGainReduction() const { return currentGainReduction; }
-
-private:
-    float sampleRate = 44100.0f;
-    float threshold = -10.0f;
-    float ratio = 4.0f;
-    float attack = 5.0f;
-    float release = 50.0f;
-    float knee = 3.0f;
-    float inputGain = 1.0f;
-    float outputGain = 1.0f;
-    float mix = 1.0f;
-    
-    float alphaAttack = 0.0f;
-    float alphaRelease = 0.0f;
-    float envelope = 0.0f;
-    float currentGainReduction = 0.0f;
-    
-    CompressorType compressorType = CompressorType::kVCA;
+    double sampleRate = 44100.0;
+    float rateHz = 1.0f;
+    double increment = 1.0 / 44100.0;
+    double startPhase = 0.0;
+    juce::int64 elapsedSamples = 0;
+    alignas(32) float framePhases[AudioSimd::Vec::width] {};
 };
 
-//==============================================================================
-// AudioExpander - Expansor/Gate de ruido
-//==============================================================================
-class AudioExpander
+/**
+ * @class AudioDelay
+ * @brief Eco con realimentación, en milisegundos o sincronizado al tempo
+ *
+ * Un AudioDelayLine por instancia. El tiempo de retardo va en rampa de
+ * 200 ms, así que cambiarlo desliza la altura como una cinta en lugar de
+ * saltar; la lectura es siempre fraccionaria. En el lazo hay un paso bajo de
+ * un polo (las repeticiones se oscurecen), que es la única parte escalar.
+ */
+class AudioDelay
 {
 public:
-    AudioExpander() = default;
-    ~AudioExpander() = default;
+    static constexpr float maxDelayMs = 4000.0f;
+    
+    AudioDelay() = default;
+    ~AudioDelay() = default;
     
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = static_cast<float>(spec.sampleRate);
+        numChannels = juce::jmin(static_cast<int>(spec.numChannels), maxFrameChannels);
+        delayLine.prepare(numChannels, static_cast<int>(std::ceil(maxDelayMs * 0.001f * sampleRate)) + 4);
+        delaySamples.prepare(spec.sampleRate, 0.2);
+        feedback.prepare(spec.sampleRate);
+        mix.prepare(spec.sampleRate);
+        updateDelayTarget();
+        setHighCut(highCutHz);
         reset();
     }
     
     void reset()
     {
-        envelope = 0.0f;
+        delayLine.reset();
+        dampingStates.fill(0.0f);
+        delaySamples.setCurrentAndTargetValue(delaySamples.getTargetValue());
     }
     
-    template <typename SampleType>
-    SampleType processSample(SampleType input)
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
     {
-        auto inputLevel = std::abs(input);
-        auto inputLevelDB = juce::Decibels::gainToDecibels(inputLevel + 0.00001f);
-        
-        // Actualizar envolvente
-        if (inputLevelDB > envelope)
-            envelope += (inputLevelDB - envelope) * alphaAttack;
-        else
-            envelope += (inputLevelDB - envelope) * alphaRelease;
-        
-        // Calcular expansión
-        SampleType gain = 1.0f;
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    // Función de trama (frame, numChannels, numValid), in-place
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
         
-        if (envelope < threshold)
+        return [this](Vec* frame, int frameChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
         {
-            auto belowThreshold = threshold - envelope;
-            auto expansion = belowThreshold * (ratio - 1.0f);
-            gain = juce::Decibels::decibelsToGain(-expansion);
-        }
-        
-        return input * gain;
+            const int channels = juce::jmin(frameChannels, numChannels);
+            const auto delays = delaySamples.nextFrame(numValid);
+            const auto feedbackGain = feedback.nextFrame(numValid);
+            const auto amount = mix.nextFrame(numValid);
+            
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                // Se lee antes de escribir: el retardo no baja de minFeedbackDelay
+                alignas(32) float lanes[Vec::width];
+                delayLine.readInterpolated(ch, delays).store(lanes);
+                
+                auto& state = dampingStates[static_cast<size_t>(ch)];
+                
+                for (int i = 0; i < numValid; ++i)
+                {
+                    state = lanes[i] + dampingPole * (state - lanes[i]);
+                    lanes[i] = state;
+                }
+                
+                const auto wet = Vec::load(lanes);
+                const auto dry = frame[ch];
+                delayLine.write(ch, dry + wet * feedbackGain, numValid);
+                frame[ch] = dry + (wet - dry) * amount;
+            }
+            
+            delayLine.advance(numValid);
+        };
     }
     
-    void setThreshold(float newThreshold)
+    void setDelayTime(float newDelayMs)
     {
-        threshold = newThreshold;
+        tempoSynced = false;
+        delayMs = newDelayMs;
+        updateDelayTarget();
     }
     
-    void setRatio(float newRatio)
+    // Retardo de noteBeats negras al tempo dado (0.75 = corchea con puntillo)
+    void setTempoSync(double bpm, float noteBeats)
     {
-        ratio = juce::jlimit(1.0f, 10.0f, newRatio);
+        tempoSynced = true;
+        tempoBpm = juce::jmax(1.0, bpm);
+        syncBeats = noteBeats;
+        updateDelayTarget();
     }
     
-    void setAttack(float newAttack)
+    void setFeedback(float newFeedback)
     {
-        attack = juce::jlimit(0.1f, 50.0f, newAttack);
-        alphaAttack = 1.0f - std::exp(-1.0f / (attack * 0.001f * sampleRate));
+        feedback.setTargetValue(juce::jlimit(0.0f, 0.95f, newFeedback));
     }
     
-    void setRelease(float newRelease)
+    // Corte del paso bajo del lazo, en Hz
+    void setHighCut(float newHighCutHz)
     {
-        release = juce::jlimit(10.0f, 500.0f, newRelease);
-        alphaRelease = 1.0f - std::exp(-1.0f / (release * 0.001f * sampleRate));
+        highCutHz = juce::jlimit(200.0f, 20000.0f, newHighCutHz);
+        dampingPole = std::exp(-juce::MathConstants<float>::twoPi * juce::jmin(highCutHz, 0.45f * sampleRate) / sampleRate);
+    }
+    
+    void setMix(float newMix)
+    {
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
     }
 
 private:
+    void updateDelayTarget() noexcept
+    {
+        const auto seconds = tempoSynced ? static_cast<float>(60.0 / tempoBpm) * syncBeats : delayMs * 0.001f;
+        delaySamples.setTargetValue(juce::jlimit(AudioDelayLine::minFeedbackDelay, maxDelayMs * 0.001f * sampleRate, seconds * sampleRate));
+    }
+    
     float sampleRate = 44100.0f;
-    float threshold = -40.0f;
-    float ratio = 2.0f;
-    float attack = 1.0f;
-    float release = 100.0f;
+    int numChannels = 2;
     
-    float alphaAttack = 0.0f;
-    float alphaRelease = 0.0f;
-    float envelope = 0.0f;
+    float delayMs = 375.0f;
+    bool tempoSynced = false;
+    double tempoBpm = 120.0;
+    float syncBeats = 1.0f;
+    float highCutHz = 8000.0f;
+    float dampingPole = 0.0f;
+    
+    AudioParameterSmoother delaySamples { 375.0f * 44.1f };
+    AudioParameterSmoother feedback { 0.35f };
+    AudioParameterSmoother mix { 0.3f };
+    
+    AudioDelayLine delayLine;
+    std::array<float, maxFrameChannels> dampingStates {};
 };
 
-//==============================================================================
-// AudioDistortion - Distorsión con múltiples tipos de clippers
-//==============================================================================
-class AudioDistortion
+/**
+ * @class AudioChorus
+ * @brief Chorus de 1 a 4 voces sobre una línea de retardo compartida
+ *
+ * Cada voz es una lectura fraccionaria alrededor del retardo central,
+ * modulada por el mismo AudioLfo con la fase repartida entre voces y
+ * desplazada un cuarto de ciclo por canal. El coste crece exactamente con
+ * el número de voces: por voz, un seno vectorial y una lectura interpolada
+ * por canal y trama.
+ */
+class AudioChorus
 {
 public:
-    enum class ClipperType
-    {
-        kSoft,
-        kHard,
-        kTube,
-        kFoldback
-    };
+    static constexpr int maxVoices = 4;
+    static constexpr float maxDelayMs = 40.0f;
     
-    AudioDistortion() = default;
-    ~AudioDistortion() = default;
+    AudioChorus() = default;
+    ~AudioChorus() = default;
     
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = static_cast<float>(spec.sampleRate);
+        numChannels = juce::jmin(static_cast<int>(spec.numChannels), maxFrameChannels);
+        delayLine.prepare(numChannels, static_cast<int>(std::ceil(maxDelayMs * 0.001f * sampleRate)) + 4);
+        lfo.prepare(spec.sampleRate);
+        centreSamples.prepare(spec.sampleRate);
+        depthSamples.prepare(spec.sampleRate);
+        mix.prepare(spec.sampleRate);
+        updateDelayTargets();
+        reset();
     }
     
-    template <typename SampleType>
-    SampleType processSample(SampleType input)
+    void reset()
     {
-        auto sample = input * drive;
-        
-        // Aplicar tipo de clipper
-        switch (clipperType)
-        {
-            case ClipperType::kSoft:
-                sample = softClipper(sample);
-                break;
-                
-            case ClipperType::kHard:
-                sample = hardClipper(sample);
-                break;
-                
-            case ClipperType::kTube:
-                sample = tubeClipper(sample);
-                break;
-                
-            case ClipperType::kFoldback:
-                sample = foldbackClipper(sample);
-                break;
-        }
-        
-        // Mix y output gain
-        auto output = input + (sample - input) * mix;
-        return output * outputGain;
+        delayLine.reset();
+        lfo.reset();
+        centreSamples.setCurrentAndTargetValue(centreSamples.getTargetValue());
+        depthSamples.setCurrentAndTargetValue(depthSamples.getTargetValue());
     }
     
-    void setDrive(float newDrive)
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
     {
-        drive = juce::jlimit(1.0f, 50.0f, newDrive);
+        processContextInFrames(context, makeFrameKernel());
     }
     
-    void setMix(float newMix)
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
     {
-        mix = juce::jlimit(0.0f, 1.0f, newMix);
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
     }
     
-    void setOutputGain(float newGain)
+    // Función de trama (frame, numChannels, numValid), in-place
+    auto makeFrameKernel() noexcept
     {
-        outputGain = juce::jlimit(0.0f, 2.0f, newGain);
+        using AudioSimd::Vec;
+        
+        return [this, voices = numVoices](Vec* frame, int frameChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
+        {
+            const int channels = juce::jmin(frameChannels, numChannels);
+            const auto centre = centreSamples.nextFrame(numValid);
+            const auto depth = depthSamples.nextFrame(numValid);
+            const auto amount = mix.nextFrame(numValid);
+            const auto voiceGain = Vec(1.0f / static_cast<float>(voices));
+            const auto minDelay = Vec(AudioDelayLine::minInterpolatedDelay);
+            
+            // Sin realimentación: se escribe primero y se puede leer a 2 muestras
+            for (int ch = 0; ch < channels; ++ch)
+                delayLine.write(ch, frame[ch], numValid);
+            
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                auto wet = Vec(0.0f);
+                
+                for (int voice = 0; voice < voices; ++voice)
+                {
+                    const auto phaseOffset = static_cast<float>(voice) / static_cast<float>(voices) + 0.25f * static_cast<float>(ch);
+                    // Centro y excursión van en rampas separadas: mientras una
+                    // alcanza a la otra el retardo podría bajar del mínimo
+                    const auto delays = AudioSimd::max(centre + depth * lfo.valuesAt(phaseOffset), minDelay);
+                    wet = wet + delayLine.readInterpolated(ch, delays);
+                }
+                
+                const auto dry = frame[ch];
+                frame[ch] = dry + (wet * voiceGain - dry) * amount;
+            }
+            
+            lfo.advance(numValid);
+            delayLine.advance(numValid);
+        };
     }
     
-    void setClipperType(ClipperType newType)
+    void setNumVoices(int newNumVoices)
     {
-        clipperType = newType;
+        numVoices = juce::jlimit(1, maxVoices, newNumVoices);
     }
-
-private:
-    template <typename SampleType>
-    SampleType softClipper(SampleType input)
+    
+    void setRate(float newRateHz)
     {
-        return std::tanh(input);
+        lfo.setRate(juce::jlimit(0.01f, 10.0f, newRateHz));
     }
     
-    template <typename SampleType>
-    SampleType hardClipper(SampleType input)
+    // Retardo central y excursión en ms; la excursión no pasa del centro
+    void setDelay(float newCentreMs)
     {
-        return juce::jlimit(SampleType(-1.0), SampleType(1.0), input);
+        centreMs = juce::jlimit(1.0f, 0.5f * maxDelayMs, newCentreMs);
+        updateDelayTargets();
     }
     
-    template <typename SampleType>
-    SampleType tubeClipper(SampleType input)
+    void setDepth(float newDepthMs)
     {
-        auto abs_input = std::abs(input);
-        
-        if (abs_input < 1.0f / 3.0f)
-            return input * 2.0f;
-        else if (abs_input < 2.0f / 3.0f)
-            return (3.0f - std::pow(2.0f - 3.0f * abs_input, 2.0f)) / 3.0f * (input > 0 ? 1.0f : -1.0f);
-        else
-            return input > 0 ? 1.0f : -1.0f;
+        depthMs = juce::jlimit(0.0f, 0.5f * maxDelayMs, newDepthMs);
+        updateDelayTargets();
     }
     
-    template <typename SampleType>
-    SampleType foldbackClipper(SampleType input)
+    void setMix(float newMix)
     {
-        auto sample = input;
-        
-        while (std::abs(sample) > 1.0f)
-        {
-            if (sample > 1.0f)
-                sample = 2.0f - sample;
-            else if (sample < -1.0f)
-                sample = -2.0f - sample;
-        }
-        
-        return sample;
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
+    }
+
+private:
+    // centro - excursión >= minInterpolatedDelay y centro + excursión <= maxDelayMs
+    void updateDelayTargets() noexcept
+    {
+        const auto samplesPerMs = 0.001f * sampleRate;
+        const auto centre = juce::jmax(centreMs * samplesPerMs, 2.0f * AudioDelayLine::minInterpolatedDelay);
+        centreSamples.setTargetValue(centre);
+        depthSamples.setTargetValue(juce::jmin(depthMs * samplesPerMs, centre - AudioDelayLine::minInterpolatedDelay));
     }
     
     float sampleRate = 44100.0f;
-    float drive = 1.0f;
-    float mix = 1.0f;
-    float outputGain = 0.5f;
-    ClipperType clipperType = ClipperType::kSoft;
+    int numChannels = 2;
+    int numVoices = 2;
+    float centreMs = 15.0f;
+    float depthMs = 3.0f;
+    
+    AudioParameterSmoother centreSamples { 15.0f * 44.1f };
+    AudioParameterSmoother depthSamples { 3.0f * 44.1f };
+    AudioParameterSmoother mix { 0.5f };
+    
+    AudioLfo lfo;
+    AudioDelayLine delayLine;
 };
 
-//==============================================================================
-// AudioBitCrusher - Reducción de bits y sample rate
-//==============================================================================
-class AudioBitCrusher
+/**
+ * @class AudioFlanger
+ * @brief Flanger con realimentación positiva o negativa
+ *
+ * Una lectura fraccionaria por canal que barre entre el retardo manual y el
+ * manual más la excursión, con el LFO desplazado un cuarto de ciclo por
+ * canal. La realimentación obliga a leer antes de escribir, así que el
+ * barrido no baja de AudioDelayLine::minFeedbackDelay (unos 0.25 ms a
+ * 44.1 kHz) en lugar de llegar a cero.
+ */
+class AudioFlanger
 {
 public:
-    AudioBitCrusher() = default;
-    ~AudioBitCrusher() = default;
+    static constexpr float maxDelayMs = 20.0f;
+    
+    AudioFlanger() = default;
+    ~AudioFlanger() = default;
     
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = static_cast<float>(spec.sampleRate);
-        phase = 0.0f;
+        numChannels = juce::jmin(static_cast<int>(spec.numChannels), maxFrameChannels);
+        delayLine.prepare(numChannels, static_cast<int>(std::ceil(maxDelayMs * 0.001f * sampleRate)) + 16);
+        lfo.prepare(spec.sampleRate);
+        manualSamples.prepare(spec.sampleRate);
+        depthSamples.prepare(spec.sampleRate);
+        feedback.prepare(spec.sampleRate);
+        mix.prepare(spec.sampleRate);
+        updateDelayTargets();
+        reset();
     }
     
-    template <typename SampleType>
-    SampleType processSample(SampleType input)
+    void reset()
     {
-        // Reducción de sample rate
-        phase += crushRate / sampleRate;
+        delayLine.reset();
+        lfo.reset();
+        manualSamples.setCurrentAndTargetValue(manualSamples.getTargetValue());
+        depthSamples.setCurrentAndTargetValue(depthSamples.getTargetValue());
+    }
+    
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        processContextInFrames(context, makeFrameKernel());
+    }
+    
+    // Para AudioProcessorChain: visitor recibe la función de trama
+    template <typename Visitor>
+    void withFrameKernel(Visitor&& visitor) noexcept
+    {
+        auto kernel = makeFrameKernel();
+        visitor(kernel);
+    }
+    
+    // Función de trama (frame, numChannels, numValid), in-place
+    auto makeFrameKernel() noexcept
+    {
+        using AudioSimd::Vec;
         
-        if (phase >= 1.0f)
+        return [this](Vec* frame, int frameChannels, int numValid) noexcept AUDIO_SIMD_KERNEL_INLINE
         {
-            phase -= 1.0f;
-            lastOutput = input;
+            const int channels = juce::jmin(frameChannels, numChannels);
+            const auto base = manualSamples.nextFrame(numValid) + AudioDelayLine::minFeedbackDelay;
+            const auto halfDepth = depthSamples.nextFrame(numValid) * 0.5f;
+            const auto feedbackGain = feedback.nextFrame(numValid);
+            const auto amount = mix.nextFrame(numValid);
             
-            // Reducción de bits
-            if (bitDepth < 16.0f)
+            for (int ch = 0; ch < channels; ++ch)
             {
-                auto steps = std::pow(2.0f, bitDepth);
-                lastOutput = std::floor(lastOutput * steps) / steps;
+                const auto delays = base + halfDepth * (lfo.valuesAt(0.25f * static_cast<float>(ch)) + 1.0f);
+                const auto wet = delayLine.readInterpolated(ch, delays);
+                const auto dry = frame[ch];
+                delayLine.write(ch, dry + wet * feedbackGain, numValid);
+                frame[ch] = dry + (wet - dry) * amount;
             }
-        }
-        
-        // Mix
-        return input + (lastOutput - input) * mix;
+            
+            lfo.advance(numValid);
+            delayLine.advance(numValid);
+        };
     }
     
-    void setCrushRate(float newRate)
+    void setRate(float newRateHz)
     {
-        crushRate = juce::jlimit(100.0f, sampleRate, newRate);
+        lfo.setRate(juce::jlimit(0.01f, 10.0f, newRateHz));
     }
     
-    void setBitDepth(float newDepth)
+    // Retardo mínimo del barrido y excursión, en ms
+    void setDelay(float newManualMs)
+    {
+        manualMs = juce::jlimit(0.0f, 0.5f * maxDelayMs, newManualMs);
+        updateDelayTargets();
+    }
+    
+    void setDepth(float newDepthMs)
+    {
+        depthMs = juce::jlimit(0.0f, 0.5f * maxDelayMs, newDepthMs);
+        updateDelayTargets();
+    }
+    
+    // Negativa vacía los graves en lugar de reforzar los picos
+    void setFeedback(float newFeedback)
     {
-        bitDepth = juce::jlimit(1.0f, 16.0f, newDepth);
+        feedback.setTargetValue(juce::jlimit(-0.95f, 0.95f, newFeedback));
     }
     
     void setMix(float newMix)
     {
-        mix = juce::jlimit(0.0f, 1.0f, newMix);
+        mix.setTargetValue(juce::jlimit(0.0f, 1.0f, newMix));
     }
 
 private:
+    void updateDelayTargets() noexcept
+    {
+        const auto samplesPerMs = 0.001f * sampleRate;
+        manualSamples.setTargetValue(manualMs * samplesPerMs);
+        depthSamples.setTargetValue(depthMs * samplesPerMs);
+    }
+    
     float sampleRate = 44100.0f;
-    float crushRate = 44100.0f;
-    float bitDepth = 16.0f;
-    float mix = 1.0f;
-    float phase = 0.0f;
-    float lastOutput = 0.0f;
+    int numChannels = 2;
+    float manualMs = 1.0f;
+    float depthMs = 3.0f;
+    
+    AudioParameterSmoother manualSamples { 44.1f };
+    AudioParameterSmoother depthSamples { 3.0f * 44.1f };
+    AudioParameterSmoother feedback { 0.5f };
+    AudioParameterSmoother mix { 0.5f };
+    
+    AudioLfo lfo;
+    AudioDelayLine delayLine;
 };
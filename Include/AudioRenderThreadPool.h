@@ -0,0 +1,109 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @class AudioRenderThreadPool
+ * @brief Pool fijo de hilos de tiempo real que reparte un grafo de tareas
+ *
+ * Dentro de un único callback, el hilo de audio actúa como trabajador 0 y los
+ * hilos del pool ejecutan en paralelo las ramas independientes del grafo.
+ * Cada trabajador tiene su propia cola (deque Chase-Lev) y roba tareas de las
+ * demás cuando se queda sin trabajo. Las dependencias se cuentan con atómicos
+ * que se reinician en cada bloque; no hay mutex en el camino de ejecución.
+ * Los trabajadores ociosos giran un tiempo breve y después se aparcan; el hilo
+ * de audio sólo los despierta si alguno está aparcado.
+ */
+class AudioRenderThreadPool
+{
+public:
+    // Trabajo que ejecuta cada tarea (implementado por la secuencia de render).
+    // workerIndex identifica el hilo que la ejecuta: 0 es el hilo de audio.
+    struct Job
+    {
+        virtual ~Job() = default;
+        virtual void runTask(int taskIndex, int workerIndex) = 0;
+    };
+
+    /**
+     * @class WorkDeque
+     * @brief Deque acotada de Chase-Lev: el dueño empuja/saca por abajo, los ladrones roban por arriba
+     */
+    class WorkDeque
+    {
+    public:
+        explicit WorkDeque(int capacity);
+
+        void push(int task);          // sólo el dueño
+        bool pop(int& task);          // sólo el dueño
+        bool steal(int& task);        // cualquier otro trabajador
+
+    private:
+        std::unique_ptr<std::atomic<int>[]> tasks;
+        juce::int64 mask = 0;
+        std::atomic<juce::int64> top { 0 };
+        std::atomic<juce::int64> bottom { 0 };
+    };
+
+    /**
+     * @class Schedule
+     * @brief Estado de planificación de un grafo compilado
+     *
+     * Se crea fuera del hilo de audio junto con la secuencia de render, así que
+     * contadores y colas ya están reservados cuando llega el callback.
+     */
+    class Schedule
+    {
+    public:
+        int getNumTasks() const { return static_cast<int>(initialDependencies.size()); }
+
+    private:
+        friend class AudioRenderThreadPool;
+
+        std::vector<int> initialDependencies;
+        std::vector<int> successorOffsets;   // numTasks + 1 entradas
+        std::vector<int> successors;
+        std::vector<int> rootTasks;
+
+        std::unique_ptr<std::atomic<int>[]> pendingDependencies;
+        std::atomic<int> remainingTasks { 0 };
+        std::vector<std::unique_ptr<WorkDeque>> deques;   // una por trabajador
+    };
+
+    explicit AudioRenderThreadPool(int numWorkerThreads = getDefaultNumWorkerThreads());
+    ~AudioRenderThreadPool();
+
+    // Arrancar/detener los hilos (fuera del hilo de audio)
+    void start(double blockPeriodMs);
+    void stop();
+    bool isRunning() const { return running; }
+
+    int getNumWorkerThreads() const { return static_cast<int>(workers.size()); }
+    static int getDefaultNumWorkerThreads();
+
+    // Construir la planificación: dependencies[i] contiene las tareas de las que depende i
+    std::unique_ptr<Schedule> createSchedule(const std::vector<std::vector<int>>& dependencies) const;
+
+    // Hilo de audio: ejecuta todas las tareas y vuelve cuando han terminado
+    void execute(Schedule& schedule, Job& job);
+
+private:
+    class Worker;
+
+    void participate(int workerIndex);
+    void workUntilDone(Schedule& schedule, Job& job, int workerIndex);
+    bool stealTask(Schedule& schedule, int thiefIndex, int& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool running = false;
+
+    std::atomic<juce::uint64> blockGeneration { 0 };
+    std::atomic<Schedule*> currentSchedule { nullptr };
+    Job* currentJob = nullptr;
+    std::atomic<int> activeWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioRenderThreadPool)
+};
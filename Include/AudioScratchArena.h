@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+
+/**
+ * @class AudioScratchArena
+ * @brief Memoria temporal para el hilo de audio, reservada de antemano
+ *
+ * Sustituye a los AudioBuffer temporales dentro del callback: toda la memoria
+ * se reserva en prepare() y allocate() sólo avanza un índice, así que pedir
+ * buffers en el hilo de audio nunca llega al sistema. reset() devuelve todo
+ * de golpe al empezar cada bloque. Los canales se alinean a 64 bytes para no
+ * romper el acceso SIMD. Un arena pertenece a un único hilo.
+ */
+class AudioScratchArena
+{
+public:
+    AudioScratchArena() = default;
+
+    // Fuera del hilo de audio: capacidad para numChannels canales de maxBlockSize muestras
+    void prepare(int numChannels, int maxBlockSize);
+    void release();
+
+    // Hilo de audio
+    void reset() noexcept
+    {
+        usedSamples = 0;
+        usedChannels = 0;
+    }
+
+    /**
+     * Devuelve una vista de numChannels x numSamples sobre la memoria del
+     * arena, sin inicializar. Si no cabe devuelve un buffer sin canales y
+     * cuenta el desbordamiento: el llamador debe saltarse su proceso.
+     */
+    juce::AudioBuffer<float> allocate(int numChannels, int numSamples) noexcept;
+
+    int getNumOverflows() const noexcept { return numOverflows.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int alignmentInFloats = 16; // 64 bytes
+
+    static size_t roundUpToAlignment(size_t numSamples) noexcept
+    {
+        return (numSamples + alignmentInFloats - 1) & ~static_cast<size_t>(alignmentInFloats - 1);
+    }
+
+    juce::HeapBlock<float> storage;
+    float* alignedStorage = nullptr;
+    size_t capacitySamples = 0;
+    size_t usedSamples = 0;
+
+    juce::HeapBlock<float*> channelPointers;
+    int capacityChannels = 0;
+    int usedChannels = 0;
+
+    std::atomic<int> numOverflows { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioScratchArena)
+};
@@ -0,0 +1,488 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(DAWMAKER_FORCE_SCALAR_SIMD) && DAWMAKER_FORCE_SCALAR_SIMD
+ #define AUDIO_SIMD_SCALAR 1
+#elif defined(__AVX__)
+ #define AUDIO_SIMD_AVX 1
+ #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define AUDIO_SIMD_SSE 1
+ #include <emmintrin.h>
+ #if defined(__SSE4_1__)
+  #include <smmintrin.h>
+ #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+ #define AUDIO_SIMD_NEON 1
+ #include <arm_neon.h>
+#else
+ #define AUDIO_SIMD_SCALAR 1
+#endif
+
+// Para las funciones de trama: se insertan siempre en el bucle que las llama,
+// también cuando una cadena fusionada junta varias (ver AudioProcessorChain)
+#if defined(__GNUC__) || defined(__clang__)
+ #define AUDIO_SIMD_KERNEL_INLINE __attribute__((always_inline))
+#else
+ #define AUDIO_SIMD_KERNEL_INLINE
+#endif
+
+/**
+ * @namespace AudioSimd
+ * @brief Vector de floats del ancho nativo (AVX, SSE, NEON o escalar)
+ *
+ * Los kernels de bloque de los procesadores se escriben una vez sobre Vec y
+ * se compilan al conjunto de instrucciones disponible. Todas las operaciones
+ * son IEEE exactas lane a lane (sin FMA ni aproximaciones), así que la versión
+ * escalar (DAWMAKER_FORCE_SCALAR_SIMD) da los mismos bits que la vectorial.
+ * Los restos de bloque más cortos que el vector se procesan con el mismo
+ * código sobre una copia rellenada con ceros.
+ */
+namespace AudioSimd
+{
+#if AUDIO_SIMD_AVX
+    using NativeVector = __m256;
+    using NativeMask = __m256;
+    static constexpr int vectorWidth = 8;
+#elif AUDIO_SIMD_SSE
+    using NativeVector = __m128;
+    using NativeMask = __m128;
+    static constexpr int vectorWidth = 4;
+#elif AUDIO_SIMD_NEON
+    using NativeVector = float32x4_t;
+    using NativeMask = uint32x4_t;
+    static constexpr int vectorWidth = 4;
+#else
+    using NativeVector = float;
+    using NativeMask = bool;
+    static constexpr int vectorWidth = 1;
+#endif
+
+    struct Mask
+    {
+        NativeMask m;
+    };
+
+    struct Vec
+    {
+        static constexpr int width = vectorWidth;
+
+        NativeVector v;
+
+        Vec() = default;
+        Vec(NativeVector native) noexcept : v(native) {}
+
+#if !AUDIO_SIMD_SCALAR
+        Vec(float scalar) noexcept : v(broadcast(scalar)) {}
+#endif
+
+        static Vec load(const float* source) noexcept
+        {
+#if AUDIO_SIMD_AVX
+            return _mm256_loadu_ps(source);
+#elif AUDIO_SIMD_SSE
+            return _mm_loadu_ps(source);
+#elif AUDIO_SIMD_NEON
+            return vld1q_f32(source);
+#else
+            return *source;
+#endif
+        }
+
+        void store(float* dest) const noexcept
+        {
+#if AUDIO_SIMD_AVX
+            _mm256_storeu_ps(dest, v);
+#elif AUDIO_SIMD_SSE
+            _mm_storeu_ps(dest, v);
+#elif AUDIO_SIMD_NEON
+            vst1q_f32(dest, v);
+#else
+            *dest = v;
+#endif
+        }
+
+        // Carga/guarda count <= width muestras; las que faltan se leen como cero
+        static Vec load(const float* source, int count) noexcept
+        {
+            if (count == width)
+                return load(source);
+
+            alignas(32) float padded[width] = {};
+            std::memcpy(padded, source, sizeof(float) * static_cast<size_t>(count));
+            return load(padded);
+        }
+
+        void store(float* dest, int count) const noexcept
+        {
+            if (count == width)
+            {
+                store(dest);
+                return;
+            }
+
+            alignas(32) float padded[width];
+            store(padded);
+            std::memcpy(dest, padded, sizeof(float) * static_cast<size_t>(count));
+        }
+
+        // Aplica una función escalar a cada lane (para lo que no tiene versión vectorial)
+        template <typename Function>
+        Vec map(Function&& function) const noexcept
+        {
+            alignas(32) float lanes[width];
+            store(lanes);
+
+            for (auto& lane : lanes)
+                lane = function(lane);
+
+            return load(lanes);
+        }
+
+    private:
+#if !AUDIO_SIMD_SCALAR
+        static NativeVector broadcast(float scalar) noexcept
+        {
+ #if AUDIO_SIMD_AVX
+            return _mm256_set1_ps(scalar);
+ #elif AUDIO_SIMD_SSE
+            return _mm_set1_ps(scalar);
+ #else
+            return vdupq_n_f32(scalar);
+ #endif
+        }
+#endif
+    };
+
+    //==============================================================================
+    // Aritmética
+    inline Vec operator+(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_add_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_add_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vaddq_f32(a.v, b.v);
+#else
+        return a.v + b.v;
+#endif
+    }
+
+    inline Vec operator-(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_sub_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_sub_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vsubq_f32(a.v, b.v);
+#else
+        return a.v - b.v;
+#endif
+    }
+
+    inline Vec operator*(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_mul_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_mul_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vmulq_f32(a.v, b.v);
+#else
+        return a.v * b.v;
+#endif
+    }
+
+    inline Vec operator/(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_div_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_div_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vdivq_f32(a.v, b.v);
+#else
+        return a.v / b.v;
+#endif
+    }
+
+    inline Vec operator-(Vec a) noexcept
+    {
+        return Vec(0.0f) - a;
+    }
+
+    // Mismo criterio que minps/maxps: si a y b no se pueden ordenar, gana b
+    inline Vec min(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_min_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_min_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vminq_f32(a.v, b.v);
+#else
+        return a.v < b.v ? a.v : b.v;
+#endif
+    }
+
+    inline Vec max(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_max_ps(a.v, b.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_max_ps(a.v, b.v);
+#elif AUDIO_SIMD_NEON
+        return vmaxq_f32(a.v, b.v);
+#else
+        return a.v > b.v ? a.v : b.v;
+#endif
+    }
+
+    inline Vec abs(Vec a) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+#elif AUDIO_SIMD_SSE
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v);
+#elif AUDIO_SIMD_NEON
+        return vabsq_f32(a.v);
+#else
+        return std::fabs(a.v);
+#endif
+    }
+
+    //==============================================================================
+    // Comparaciones y selección por lane
+    inline Mask operator<(Vec a, Vec b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) };
+#elif AUDIO_SIMD_SSE
+        return { _mm_cmplt_ps(a.v, b.v) };
+#elif AUDIO_SIMD_NEON
+        return { vcltq_f32(a.v, b.v) };
+#else
+        return { a.v < b.v };
+#endif
+    }
+
+    inline Mask operator>(Vec a, Vec b) noexcept
+    {
+        return b < a;
+    }
+
+    inline Mask operator&&(Mask a, Mask b) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return { _mm256_and_ps(a.m, b.m) };
+#elif AUDIO_SIMD_SSE
+        return { _mm_and_ps(a.m, b.m) };
+#elif AUDIO_SIMD_NEON
+        return { vandq_u32(a.m, b.m) };
+#else
+        return { a.m && b.m };
+#endif
+    }
+
+    // Lane a lane: ifTrue donde la máscara está activa, ifFalse en el resto
+    inline Vec select(Mask mask, Vec ifTrue, Vec ifFalse) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_blendv_ps(ifFalse.v, ifTrue.v, mask.m);
+#elif AUDIO_SIMD_SSE && defined(__SSE4_1__)
+        return _mm_blendv_ps(ifFalse.v, ifTrue.v, mask.m);
+#elif AUDIO_SIMD_SSE
+        return _mm_or_ps(_mm_and_ps(mask.m, ifTrue.v), _mm_andnot_ps(mask.m, ifFalse.v));
+#elif AUDIO_SIMD_NEON
+        return vbslq_f32(mask.m, ifTrue.v, ifFalse.v);
+#else
+        return mask.m ? ifTrue.v : ifFalse.v;
+#endif
+    }
+
+    inline Vec floor(Vec a) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_floor_ps(a.v);
+#elif AUDIO_SIMD_SSE && defined(__SSE4_1__)
+        return _mm_floor_ps(a.v);
+#elif AUDIO_SIMD_SSE
+        // Truncar y corregir los negativos; a partir de 2^23 todo float ya es entero
+        const Vec truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        const Vec floored = select(a < truncated, truncated - 1.0f, truncated);
+        return select(abs(a) < 8388608.0f, floored, a);
+#elif AUDIO_SIMD_NEON
+        return vrndmq_f32(a.v);
+#else
+        return std::floor(a.v);
+#endif
+    }
+
+    //==============================================================================
+    // Movimiento entre lanes: { first, a[0], ..., a[width - 2] }. Sirve para
+    // encadenar lanes en diagonal, cada una con la salida de la anterior.
+    inline Vec shiftLanesUp(Vec a, float first) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        // Sin AVX2 no hay permutación entre mitades de 128 bits: la mitad baja
+        // sube con permute2f128 y cada mitad se recompone con dos shuffles
+        const auto lowInHigh = _mm256_permute2f128_ps(a.v, a.v, 0x08);
+        const auto pairs = _mm256_shuffle_ps(lowInHigh, a.v, _MM_SHUFFLE(0, 0, 3, 3));
+        const auto shifted = _mm256_shuffle_ps(pairs, a.v, _MM_SHUFFLE(2, 1, 2, 0));
+        return _mm256_blend_ps(shifted, _mm256_set1_ps(first), 0x01);
+#elif AUDIO_SIMD_SSE
+        return _mm_move_ss(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 1, 0, 0)), _mm_set_ss(first));
+#elif AUDIO_SIMD_NEON
+        return vextq_f32(vdupq_n_f32(first), a.v, 3);
+#else
+        static_cast<void>(a);
+        return first;
+#endif
+    }
+
+    // Suma de todas las lanes en un orden fijo: cada lane con la que está a
+    // width / 2, luego a width / 4... Si varios Vec se reducen antes con el
+    // mismo esquema (la mitad alta sobre la baja), la suma da los mismos bits
+    // con cualquier ancho de vector.
+    inline float sumLanes(Vec a) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        const auto halves = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        const auto pairs = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+#elif AUDIO_SIMD_SSE
+        const auto pairs = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+#elif AUDIO_SIMD_NEON
+        const auto pairs = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+        return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#else
+        return a.v;
+#endif
+    }
+
+    //==============================================================================
+    // Complejos en formato partido: reales e imaginarios en Vec separados, como
+    // guardan los espectros AudioConvolution y AudioSpectralProcessor
+
+    // Bins por espectro redondeados a 8 floats, que cubre cualquier anchura de
+    // Vec: los bucles por bin no tienen resto y los bins de relleno valen 0
+    static constexpr int spectrumAlignment = 8;
+
+    inline constexpr int spectrumStride(int numBins) noexcept
+    {
+        return (numBins + spectrumAlignment - 1) / spectrumAlignment * spectrumAlignment;
+    }
+
+    // (ar + i ai) * (br + i bi)
+    inline void complexMultiply(Vec ar, Vec ai, Vec br, Vec bi, Vec& real, Vec& imag) noexcept
+    {
+        real = ar * br - ai * bi;
+        imag = ar * bi + ai * br;
+    }
+
+    inline Vec magnitudeSquared(Vec real, Vec imag) noexcept
+    {
+        return real * real + imag * imag;
+    }
+
+    // Ganancia real por bin; count múltiplo de Vec::width
+    inline void scaleSpectrum(float* real, float* imag, const float* gains, int count) noexcept
+    {
+        for (int bin = 0; bin < count; bin += Vec::width)
+        {
+            const auto gain = Vec::load(gains + bin);
+            (Vec::load(real + bin) * gain).store(real + bin);
+            (Vec::load(imag + bin) * gain).store(imag + bin);
+        }
+    }
+
+    //==============================================================================
+    // Las mismas operaciones sobre float, para que un kernel escrito como
+    // plantilla sirva tanto por lanes como muestra a muestra con idéntico resultado
+    inline float min(float a, float b) noexcept { return a < b ? a : b; }
+    inline float max(float a, float b) noexcept { return a > b ? a : b; }
+    inline float abs(float a) noexcept { return std::fabs(a); }
+    inline float floor(float a) noexcept { return std::floor(a); }
+    inline float select(bool mask, float ifTrue, float ifFalse) noexcept { return mask ? ifTrue : ifFalse; }
+
+    inline float splitExponent(float x, float& mantissa) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const std::uint32_t mantissaBits = (bits & 0x007fffffu) | 0x3f800000u;
+        std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+        return static_cast<float>(static_cast<std::int32_t>(bits >> 23) - 127);
+    }
+
+    inline float exp2Integer(float n) noexcept
+    {
+        const auto bits = static_cast<std::uint32_t>(static_cast<std::int32_t>(n) + 127) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    //==============================================================================
+    // Acceso al formato IEEE para las aproximaciones de AudioFastMath
+
+#if AUDIO_SIMD_SSE || AUDIO_SIMD_AVX
+    namespace detail
+    {
+        inline __m128 splitExponent128(__m128 x, __m128& mantissa) noexcept
+        {
+            const auto bits = _mm_castps_si128(x);
+            mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                                     _mm_set1_epi32(0x3f800000)));
+            return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        }
+
+        inline __m128 exp2Integer128(__m128 n) noexcept
+        {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+        }
+    }
+#endif
+
+    // x > 0 normal: devuelve el exponente (como float) y deja la mantisa en [1, 2)
+    inline Vec splitExponent(Vec x, Vec& mantissa) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        // Sin AVX2 no hay enteros de 256 bits: por mitades
+        __m128 mantissaLow, mantissaHigh;
+        const auto exponentLow = detail::splitExponent128(_mm256_castps256_ps128(x.v), mantissaLow);
+        const auto exponentHigh = detail::splitExponent128(_mm256_extractf128_ps(x.v, 1), mantissaHigh);
+        mantissa = _mm256_insertf128_ps(_mm256_castps128_ps256(mantissaLow), mantissaHigh, 1);
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(exponentLow), exponentHigh, 1);
+#elif AUDIO_SIMD_SSE
+        return detail::splitExponent128(x.v, mantissa.v);
+#elif AUDIO_SIMD_NEON
+        const auto bits = vreinterpretq_u32_f32(x.v);
+        mantissa = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+        return vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+#else
+        return splitExponent(x.v, mantissa.v);
+#endif
+    }
+
+    // 2^n para n entero en [-126, 127]
+    inline Vec exp2Integer(Vec n) noexcept
+    {
+#if AUDIO_SIMD_AVX
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(detail::exp2Integer128(_mm256_castps256_ps128(n.v))),
+                                    detail::exp2Integer128(_mm256_extractf128_ps(n.v, 1)), 1);
+#elif AUDIO_SIMD_SSE
+        return detail::exp2Integer128(n.v);
+#elif AUDIO_SIMD_NEON
+        return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n.v), vdupq_n_s32(127)), 23));
+#else
+        return exp2Integer(n.v);
+#endif
+    }
+}
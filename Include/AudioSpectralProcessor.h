@@ -0,0 +1,281 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class AudioSpectralProcessor
+ * @brief Motor STFT de solapamiento-suma para efectos espectrales
+ *
+ * Cada hopSize muestras enventana las últimas fftSize muestras de cada canal,
+ * las pasa a frecuencia y entrega los espectros de todos los canales a la
+ * función de trama (setFrameCallback()), que los modifica en el sitio. Luego
+ * vuelve al tiempo, aplica la ventana de síntesis y suma con solapamiento.
+ * La ventana de síntesis lleva incorporada la normalización del
+ * solapamiento, así que sin función de trama la salida es la entrada
+ * retrasada fftSize muestras (getLatencySamples()) con cualquier ventana y
+ * solapamiento.
+ *
+ * Los espectros se entregan partidos (reales | imaginarios) con los bins
+ * redondeados por AudioSimd::spectrumStride(): los efectos los recorren a Vec
+ * enteros con las funciones de complejos de AudioSimd.
+ *
+ * La FFT y las ventanas de una configuración (tamaño, solapamiento, ventana)
+ * se crean una vez y las comparten todas las instancias que la usan; los
+ * métodos de juce::dsp::FFT son const y se pueden llamar desde varios hilos.
+ * Cada instancia sólo reserva sus buffers de entrada, salida y espectro, y lo
+ * hace en prepare().
+ */
+class AudioSpectralProcessor
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int minFftOrder = 7;
+    // La FFT de reserva de JUCE (sin motor nativo) sólo usa la pila, sin
+    // reservar memoria, hasta 16384 puntos
+    static constexpr int maxFftOrder = 14;
+
+    enum class Window
+    {
+        kHann,
+        kHamming,
+        kBlackmanHarris
+    };
+
+    struct Settings
+    {
+        int fftOrder = 11;          // fftSize = 2^fftOrder
+        int overlap = 4;            // hopSize = fftSize / overlap: 2, 4 u 8
+        Window window = Window::kHann;
+    };
+
+    // Una trama: los espectros de todos los canales en el mismo instante
+    struct Frame
+    {
+        float* const* real;         // [canal][bin]
+        float* const* imag;
+        int numChannels;
+        int numBins;                // fftSize / 2 + 1
+        int stride;                 // numBins redondeado a 8; los bins de relleno valen 0
+        int fftSize;
+        int hopSize;
+        double sampleRate;
+    };
+
+    using FrameCallback = std::function<void(const Frame&)>;
+
+    AudioSpectralProcessor();
+    ~AudioSpectralProcessor();
+
+    // Fuera del hilo de audio
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Fuera del hilo de audio, con el callback detenido: si ya está preparado
+    // se vuelve a preparar, y los efectos conectados también
+    void setSettings(const Settings& newSettings);
+    const Settings& getSettings() const noexcept { return settings; }
+
+    // Fuera del hilo de audio, con el callback detenido. Se llama en el hilo
+    // de audio una vez por trama: no debe reservar memoria ni bloquear.
+    void setFrameCallback(FrameCallback newCallback);
+
+    int getLatencySamples() const noexcept { return fftSize; }
+    int getFftSize() const noexcept { return fftSize; }
+    int getHopSize() const noexcept { return hopSize; }
+    int getNumBins() const noexcept { return fftSize / 2 + 1; }
+    int getStride() const noexcept { return stride; }
+    int getNumChannels() const noexcept { return numChannels; }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    // Magnitud del bin de un seno a 0 dBFS con la ventana de análisis: la
+    // referencia de los umbrales en dB de los efectos
+    float getFullScaleMagnitude() const noexcept;
+
+    // Ganancia que conserva el nivel cuando las tramas no son coherentes
+    // entre sí (fases aleatorias): sus solapamientos se suman en potencia
+    float getIncoherentGain() const noexcept;
+
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        const auto channels = juce::jmin(static_cast<int>(outputBlock.getNumChannels()), numChannels);
+        std::array<const float*, maxChannels> inputs {};
+        std::array<float*, maxChannels> outputs {};
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            inputs[static_cast<size_t>(ch)] = inputBlock.getChannelPointer(static_cast<size_t>(ch));
+            outputs[static_cast<size_t>(ch)] = outputBlock.getChannelPointer(static_cast<size_t>(ch));
+        }
+
+        processSamples(inputs.data(), outputs.data(), channels, static_cast<int>(outputBlock.getNumSamples()));
+    }
+
+private:
+    struct Plan;
+
+    // FFT y ventanas de una configuración, compartidas entre instancias
+    static std::shared_ptr<const Plan> getSharedPlan(const Settings& settings);
+
+    void allocate();
+    void processSamples(const float* const* inputs, float* const* outputs, int channels, int numSamples) noexcept;
+    void processFrame(int channels) noexcept;
+
+    float* inputFifo(int channel) noexcept { return inputFifos.data() + static_cast<size_t>(channel * fftSize); }
+    float* outputAccumulator(int channel) noexcept { return outputAccumulators.data() + static_cast<size_t>(channel * fftSize); }
+
+    Settings settings;
+    std::shared_ptr<const Plan> plan;
+    FrameCallback callback;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int fftSize = 0;
+    int hopSize = 0;
+    int stride = 0;
+    bool prepared = false;
+
+    std::vector<float> inputFifos;          // [canal][fftSize]: las últimas fftSize muestras
+    std::vector<float> outputAccumulators;  // [canal][fftSize]: suma con solapamiento en curso
+    std::vector<float> spectra;             // [canal][reales | imaginarios]
+    std::vector<float> fftBuffer;           // 2 * fftSize
+    std::array<float*, maxChannels> realPointers {};
+    std::array<float*, maxChannels> imagPointers {};
+    int hopPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioSpectralProcessor)
+};
+
+//==============================================================================
+// Efectos espectrales: se preparan con el AudioSpectralProcessor ya preparado
+// y se conectan como función de trama, p. ej.
+//     stft.setFrameCallback([&gate](const auto& frame) { gate.process(frame); });
+// Cada cambio de configuración del procesador obliga a prepararlos otra vez:
+// process() comprueba que la trama tiene el stride con el que se prepararon.
+// Los setters se llaman desde fuera del hilo de audio, como los del resto de
+// procesadores.
+//==============================================================================
+
+/**
+ * @class AudioSpectralGate
+ * @brief Puerta por bin: atenúa los bins por debajo del umbral
+ *
+ * Cada bin abre en cuanto supera el umbral y cierra con el tiempo de
+ * liberación, contado en tramas. Toda la trama en Vec.
+ */
+class AudioSpectralGate
+{
+public:
+    void prepare(const AudioSpectralProcessor& processor);
+    void reset();
+    void process(const AudioSpectralProcessor::Frame& frame) noexcept;
+
+    // Umbral en dBFS de la potencia de cada bin (relativa a un seno a 0 dBFS)
+    void setThreshold(float newThresholdDb);
+    // Atenuación de un bin cerrado
+    void setRange(float newRangeDb);
+    void setRelease(float newReleaseMs);
+
+private:
+    void updateCoefficients() noexcept;
+
+    float thresholdDb = -60.0f;
+    float rangeDb = -60.0f;
+    float releaseMs = 100.0f;
+
+    double frameRate = 44100.0 / 512.0;
+    float fullScalePower = 1.0f;
+    float thresholdPower = 0.0f;
+    float closedGain = 0.0f;
+    float releaseCoefficient = 0.0f;
+
+    int stride = 0;
+    std::vector<float> gains;               // [canal][bin]
+};
+
+/**
+ * @class AudioSpectralDenoiser
+ * @brief Reducción de ruido por sustracción espectral con perfil aprendido
+ *
+ * Mientras aprende promedia la potencia de cada bin (sin tocar la señal).
+ * Después cada bin recibe la ganancia max(suelo, 1 - k * ruido / potencia),
+ * suavizada entre tramas para no dejar "ruido musical".
+ */
+class AudioSpectralDenoiser
+{
+public:
+    void prepare(const AudioSpectralProcessor& processor);
+    void reset();
+    void process(const AudioSpectralProcessor::Frame& frame) noexcept;
+
+    // Aprender sustituye el perfil anterior
+    void setLearning(bool shouldLearn);
+    bool isLearning() const noexcept { return learning; }
+
+    // Cuánto por encima del perfil se resta (1 a 4)
+    void setSensitivity(float newSensitivity);
+    // Atenuación máxima, en dB
+    void setReduction(float newReductionDb);
+
+private:
+    bool learning = false;
+    bool restartProfile = false;
+    float sensitivity = 1.5f;
+    float floorGain = 0.1f;
+    float smoothing = 0.0f;
+
+    int stride = 0;
+    int numLearnedFrames = 0;
+    std::vector<float> noiseProfile;        // [canal][bin], potencia media
+    std::vector<float> gains;               // [canal][bin]
+};
+
+/**
+ * @class AudioSpectralFreeze
+ * @brief Congela el espectro: sostiene las magnitudes de la trama capturada
+ *
+ * Al activarse guarda la magnitud de cada bin; mientras está activo cada
+ * trama sale con esas magnitudes y fases aleatorias (de una tabla de
+ * fasores), lo que da un sostenido continuo en lugar de la misma trama
+ * repetida, al mismo nivel que la entrada. La suma con solapamiento funde
+ * la entrada y la salida.
+ */
+class AudioSpectralFreeze
+{
+public:
+    void prepare(const AudioSpectralProcessor& processor);
+    void reset();
+    void process(const AudioSpectralProcessor::Frame& frame) noexcept;
+
+    void setFrozen(bool shouldFreeze);
+    bool isFrozen() const noexcept { return frozen; }
+
+private:
+    static constexpr int numPhasors = 64;
+
+    bool frozen = false;
+    bool captured = false;
+
+    int stride = 0;
+    float gain = 1.0f;                      // getIncoherentGain()
+    std::vector<float> magnitudes;          // [canal][bin]
+    std::array<float, numPhasors> phasorReal {};
+    std::array<float, numPhasors> phasorImag {};
+    juce::uint32 randomState = 0x12345678u;
+};
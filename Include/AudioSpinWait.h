@@ -0,0 +1,30 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <thread>
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+/**
+ * @namespace AudioSpinWait
+ * @brief Espera activa de los hilos de audio (pool de render, convolución)
+ *
+ * Depende sólo de la CPU, no de la configuración de AudioSimd: la build
+ * escalar de referencia espera igual que la vectorial.
+ */
+namespace AudioSpinWait
+{
+    // Pausa breve dentro de un bucle de espera activa
+    inline void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+        __asm__ __volatile__ ("yield");
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+}
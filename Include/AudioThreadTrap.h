@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Modo de depuración/perfilado: se activa con -DDAWMAKER_AUDIO_THREAD_TRAP=ON en CMake
+#ifndef DAWMAKER_AUDIO_THREAD_TRAP
+ #define DAWMAKER_AUDIO_THREAD_TRAP 0
+#endif
+
+/**
+ * @class AudioThreadTrap
+ * @brief Detecta reservas de memoria y locks hechos desde el hilo de audio
+ *
+ * Con DAWMAKER_AUDIO_THREAD_TRAP activo se interceptan malloc/free y
+ * pthread_mutex_lock (glibc) o operator new/delete (resto de plataformas).
+ * Si la llamada ocurre dentro de un ScopedAudioThread se guarda la pila en
+ * un anillo fijo, sin reservar nada, y un hilo de fondo la simboliza y la
+ * escribe en el Logger. Sin el flag todo esto compila a nada.
+ */
+class AudioThreadTrap
+{
+public:
+    enum class Violation
+    {
+        allocation,
+        deallocation,
+        lock
+    };
+
+    static constexpr bool isCompiledIn() noexcept { return DAWMAKER_AUDIO_THREAD_TRAP != 0; }
+
+   #if DAWMAKER_AUDIO_THREAD_TRAP
+    // Marca el hilo actual como hilo de audio mientras dure el ámbito
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    // Permite una operación bloqueante conocida y acotada dentro del callback
+    struct ScopedAllowance
+    {
+        ScopedAllowance() noexcept;
+        ~ScopedAllowance() noexcept;
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllowance)
+    };
+
+    // Hilo de fondo que vuelca las infracciones al Logger (hilo de mensajes)
+    static void startReporting();
+    static void stopReporting();
+
+    // Lo llaman los interceptores; público sólo para ellos
+    static bool isTrappingCurrentThread() noexcept;
+    static void recordViolation(Violation violation, size_t numBytes) noexcept;
+   #else
+    struct ScopedAudioThread { ScopedAudioThread() noexcept {} };
+    struct ScopedAllowance   { ScopedAllowance() noexcept {} };
+
+    static void startReporting() {}
+    static void stopReporting() {}
+   #endif
+
+    AudioThreadTrap() = delete;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_events/juce_events.h>
+#include "AudioGraph.h"
+#include "AudioScratchArena.h"
+#include "ParameterTable.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @class AutomationEngine
+ * @brief Automatización de parámetros con precisión de muestra
+ *
+ * Cada parámetro de la ParameterTable puede tener una lista de puntos
+ * (posición en muestras, valor, curva hasta el siguiente punto). Las listas se
+ * editan en el hilo de mensajes y se publican al hilo de audio como una copia
+ * inmutable con un intercambio atómico, igual que el AudioGraph.
+ *
+ * En cada bloque planBlock() clasifica los parámetros: los que están quietos
+ * sólo cuestan una búsqueda binaria; los saltos (curva escalón) se devuelven
+ * como eventos con su desplazamiento dentro del bloque, para que el motor
+ * parta el bloque ahí; las rampas se dibujan muestra a muestra en memoria del
+ * arena y se entregan a los nodos sin partir nada.
+ */
+class AutomationEngine : private juce::Timer
+{
+public:
+    enum class Curve
+    {
+        linear,  // rampa lineal hasta el siguiente punto
+        step     // mantiene el valor hasta el siguiente punto
+    };
+
+    struct Breakpoint
+    {
+        juce::int64 samplePosition = 0;
+        float value = 0.0f;
+        Curve curve = Curve::linear;
+    };
+
+    // Salto de valor en una muestra concreta del bloque
+    struct Event
+    {
+        int sampleOffset = 0;
+        ParameterTable::ParameterID parameterID = ParameterTable::invalidParameterID;
+        float value = 0.0f;
+    };
+
+    struct BlockPlan
+    {
+        const Event* events = nullptr;
+        int numEvents = 0;
+        const AudioGraph::ParameterRamp* ramps = nullptr;
+        int numRamps = 0;
+    };
+
+    static constexpr int maxEventsPerBlock = 256;
+    static constexpr int maxRampsPerBlock = 64;
+
+    AutomationEngine();
+    ~AutomationEngine() override;
+
+    // Edición (hilo de mensajes). Los puntos se ordenan por posición.
+    void setLane(ParameterTable::ParameterID parameterID, std::vector<Breakpoint> points);
+    void removeLane(ParameterTable::ParameterID parameterID);
+    void clear();
+    std::vector<Breakpoint> getLane(ParameterTable::ParameterID parameterID) const;
+    int getNumLanes() const;
+
+    // Fuera del hilo de audio, con el callback detenido
+    void prepare(int maximumBlockSize);
+
+    // Hilo de audio: plan para [position, position + numSamples), numSamples <= maximumBlockSize
+    const BlockPlan& planBlock(juce::int64 position, int numSamples) noexcept;
+
+    // Hilo de audio: olvida los últimos valores enviados (tras un salto de transporte)
+    void resynchronise() noexcept { resyncRequested = true; }
+
+private:
+    struct Snapshot;
+
+    void timerCallback() override;
+    void publishLocked();
+    void reclaimRetiredSnapshots();
+
+    void addEvent(int sampleOffset, ParameterTable::ParameterID parameterID, float value) noexcept;
+
+    // Modelo (hilo de mensajes)
+    juce::CriticalSection laneLock;
+    std::map<ParameterTable::ParameterID, std::vector<Breakpoint>> lanes;
+
+    // Publicación al hilo de audio
+    std::atomic<Snapshot*> pendingSnapshot { nullptr };
+    Snapshot* activeSnapshot = nullptr; // propiedad del hilo de audio
+
+    static constexpr int retiredQueueSize = 16;
+    juce::AbstractFifo retiredFifo { retiredQueueSize };
+    std::array<Snapshot*, retiredQueueSize> retiredSnapshots {};
+
+    // Estado del hilo de audio
+    std::array<Event, maxEventsPerBlock> events {};
+    std::array<AudioGraph::ParameterRamp, maxRampsPerBlock> ramps {};
+    BlockPlan plan;
+    AudioScratchArena rampScratch;
+    bool resyncRequested = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutomationEngine)
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AudioScratchArena.h"
+
+/**
+ * @class BlockSizeAdapter
+ * @brief Adapta el tamaño de bloque del dispositivo a un bloque interno fijo
+ *
+ * El motor procesa siempre bloques de internalBlockSize muestras (potencia de
+ * dos) sobre buffers propios alineados, tenga el dispositivo el tamaño que
+ * tenga. Si el bloque del dispositivo es múltiplo del interno se trocea sin
+ * latencia; si no, las muestras pasan por un FIFO mínimo de un bloque interno
+ * y esa es exactamente la latencia añadida (getLatencySamples()).
+ */
+class BlockSizeAdapter
+{
+public:
+    BlockSizeAdapter() = default;
+
+    // Fuera del hilo de audio. internalBlockSize <= 0 desactiva el adaptador.
+    void prepare(int numChannels, int internalBlockSize, int deviceBlockSize);
+    void reset();
+
+    bool isActive() const noexcept { return blockSize > 0; }
+    int getBlockSize() const noexcept { return blockSize; }
+    int getLatencySamples() const noexcept { return useFifo ? blockSize : 0; }
+
+    /**
+     * Hilo de audio: procesa in-place la región [startSample, startSample + numSamples)
+     * de io llamando a processBlock(buffer, start, numSamples) con bloques de
+     * getBlockSize() muestras.
+     */
+    template <typename ProcessBlock>
+    void process(juce::AudioBuffer<float>& io, int startSample, int numSamples, ProcessBlock&& processBlock)
+    {
+        if (!isActive())
+        {
+            processBlock(io, startSample, numSamples);
+            return;
+        }
+
+        const int ioChannels = juce::jmin(io.getNumChannels(), numChannels);
+
+        if (!useFifo)
+        {
+            // Sin latencia: copiar cada trozo al bloque alineado y de vuelta.
+            // Un resto (dispositivo irregular) se procesa como bloque corto.
+            for (int offset = 0; offset < numSamples;)
+            {
+                const int chunk = juce::jmin(blockSize, numSamples - offset);
+                copyIn(io, startSample + offset, ioChannels, fifoBlock, 0, chunk);
+                processBlock(fifoBlock, 0, chunk);
+                copyOut(fifoBlock, 0, io, startSample + offset, ioChannels, chunk);
+                offset += chunk;
+            }
+
+            return;
+        }
+
+        // FIFO de un bloque: la salida va exactamente blockSize muestras por detrás
+        for (int offset = 0; offset < numSamples;)
+        {
+            const int segment = juce::jmin(numSamples - offset, blockSize - fillPosition);
+
+            copyIn(io, startSample + offset, ioChannels, fifoBlock, fillPosition, segment);
+            copyOut(outputBlock, fillPosition, io, startSample + offset, ioChannels, segment);
+
+            fillPosition += segment;
+            offset += segment;
+
+            if (fillPosition == blockSize)
+            {
+                processBlock(fifoBlock, 0, blockSize);
+                std::swap(fifoBlock, outputBlock);
+                fillPosition = 0;
+            }
+        }
+    }
+
+private:
+    void copyIn(const juce::AudioBuffer<float>& source, int sourceStart, int ioChannels,
+                juce::AudioBuffer<float>& dest, int destStart, int num) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (ch < ioChannels)
+                dest.copyFrom(ch, destStart, source, ch, sourceStart, num);
+            else
+                dest.clear(ch, destStart, num);
+        }
+    }
+
+    void copyOut(const juce::AudioBuffer<float>& source, int sourceStart,
+                 juce::AudioBuffer<float>& dest, int destStart, int ioChannels, int num) noexcept
+    {
+        for (int ch = 0; ch < ioChannels; ++ch)
+            dest.copyFrom(ch, destStart, source, ch, sourceStart, num);
+
+        for (int ch = ioChannels; ch < dest.getNumChannels(); ++ch)
+            dest.clear(ch, destStart, num);
+    }
+
+    int numChannels = 0;
+    int blockSize = 0;
+    bool useFifo = false;
+    int fillPosition = 0;
+
+    // Vistas sobre memoria alineada a 64 bytes
+    AudioScratchArena storage;
+    juce::AudioBuffer<float> fifoBlock;    // entrada que se acumula y se procesa in-place
+    juce::AudioBuffer<float> outputBlock;  // último bloque procesado, pendiente de salir
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockSizeAdapter)
+};
@@ -5,6 +5,7 @@
 #include "AudioScope.h"
 #include "VerticalFader.h"
 #include "CustomButtons.h"
+#include "ParameterTable.h"
 
 /**
  * @brief LookAndFeel personalizado para renderizar knobs con diferentes formas
@@ -196,6 +197,10 @@ public:
     // Método virtual para actualizar valor desde MIDI (0-127)
     virtual void updateFromMidiValue(int value) {}
     
+    // Puente de parámetros hacia el hilo de audio (claves "<nombre>/<valor>")
+    void setParameterTable(ParameterTable* table);
+    ParameterTable* getParameterTable() const { return parameterTable; }
+    
     // Callbacks
     std::function<void(DraggableWidget*)> onDeleteRequested;
     std::function<void(DraggableWidget*)> onConfigRequested;
@@ -204,6 +209,11 @@ public:
 protected:
     virtual void paintWidget(juce::Graphics& g) = 0;
     
+    // Cada widget con valores registra aquí sus parámetros y guarda los IDs
+    virtual void registerParameters() {}
+    ParameterTable::ParameterID registerParameter(const juce::String& valueName, float initialValue);
+    void pushParameterValue(ParameterTable::ParameterID parameterID, float value) const;
+    
     bool isResizing = false;
     bool isDragging = false;
 
@@ -222,6 +232,8 @@ private:
     
     juce::TextButton deleteButton;
     bool isHovered = false;
+    
+    ParameterTable* parameterTable = nullptr;
 
     void deleteButtonClicked();
 
@@ -255,11 +267,13 @@ public:
 
 protected:
     void paintWidget(juce::Graphics& g) override;
+    void registerParameters() override;
 
 private:
     juce::Slider knob;
     juce::Label label;
     CustomKnobLookAndFeel knobLookAndFeel;
+    ParameterTable::ParameterID valueParameterID = ParameterTable::invalidParameterID;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DraggableKnob)
 };
@@ -288,12 +302,14 @@ public:
 
 protected:
     void paintWidget(juce::Graphics& g) override;
+    void registerParameters() override;
 
 private:
     juce::Slider slider;
     juce::Label label;
     bool vertical;
     CustomSliderLookAndFeel sliderLookAndFeel;
+    ParameterTable::ParameterID valueParameterID = ParameterTable::invalidParameterID;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DraggableSlider)
 };
@@ -505,8 +521,8 @@ public:
     
     float getXValue() const { return xValue; }
     float getYValue() const { return yValue; }
-    void setXValue(float x) { xValue = juce::jlimit(0.0f, 1.0f, x); repaint(); }
-    void setYValue(float y) { yValue = juce::jlimit(0.0f, 1.0f, y); repaint(); }
+    void setXValue(float x) { xValue = juce::jlimit(0.0f, 1.0f, x); pushParameterValue(xParameterID, xValue); repaint(); }
+    void setYValue(float y) { yValue = juce::jlimit(0.0f, 1.0f, y); pushParameterValue(yParameterID, yValue); repaint(); }
     
     void updateFromMidiValue(int value) override;
     
@@ -516,10 +532,13 @@ public:
 
 protected:
     void paintWidget(juce::Graphics& g) override;
+    void registerParameters() override;
 
 private:
     float xValue = 0.5f; // 0-1
     float yValue = 0.5f; // 0-1
+    ParameterTable::ParameterID xParameterID = ParameterTable::invalidParameterID;
+    ParameterTable::ParameterID yParameterID = ParameterTable::invalidParameterID;
     juce::Point<float> indicatorPos;
     float indicatorSize = 20.0f;
     int xyPadStyle = 0;
@@ -582,10 +601,13 @@ public:
 
 protected:
     void paintWidget(juce::Graphics& g) override;
+    void registerParameters() override;
 
 private:
     float radius = 0.0f; // 0-1 (distancia desde el centro)
     float angle = 0.0f; // 0-1 (angulo normalizado)
+    ParameterTable::ParameterID radiusParameterID = ParameterTable::invalidParameterID;
+    ParameterTable::ParameterID angleParameterID = ParameterTable::invalidParameterID;
     juce::Point<float> stickPos;
     int joystickStyle = 0;
     juce::Colour joystickColour{0xff00ff00};
@@ -931,12 +953,14 @@ public:
 
 protected:
     void paintWidget(juce::Graphics& g) override;
+    void registerParameters() override;
 
 private:
     std::unique_ptr<class VerticalFader> fader;
     juce::Label label;
     int faderStyle = 0;
     juce::Colour faderColour = juce::Colours::blue;
+    ParameterTable::ParameterID valueParameterID = ParameterTable::invalidParameterID;
     
     void drawModernStyle(juce::Graphics& g, juce::Rectangle<int> area, float value);
     void drawClassicStyle(juce::Graphics& g, juce::Rectangle<int> area, float value);
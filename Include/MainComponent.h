@@ -8,6 +8,8 @@
 #include "ProjectManager.h"
 #include "PluginExporter.h"
 #include "IntegratedTerminal.h"
+#include "AudioCallbackMonitor.h"
+#include "OfflineRenderer.h"
 
 /**
  * @class MainComponent
@@ -23,6 +25,7 @@
  */
 class MainComponent : public juce::AudioAppComponent,
                       private juce::MidiInputCallback,
+                      private juce::Timer,
                       public juce::MenuBarModel
 {
 public:
@@ -42,6 +45,15 @@ private:
     // Motor de audio
     std::unique_ptr<AudioEngine> audioEngine;
 
+    // Medición de cada callback contra su plazo y barra de estado con la carga
+    AudioCallbackMonitor callbackMonitor;
+    juce::Label statusBar;
+    juce::int64 lastReportedOverruns = 0;
+    void timerCallback() override;
+    int getDeviceXRunCount();
+    void logCallbackReport();
+    void exportCallbackReport();
+
     // Look and Feel personalizado
     CustomLookAndFeel customLookAndFeel;
 
@@ -119,6 +131,10 @@ private:
     // Exportación MIDI y Audio
     void exportToMidi();
     void exportToAudio();
+    void startOfflineBounce(const juce::File& file, const OfflineRenderer::Settings& settings);
+
+    // Bounce offline en curso (ventana de progreso con su hilo)
+    std::unique_ptr<juce::ThreadWithProgressWindow> offlineBounce;
     
     // Nuevas funcionalidades de configuración
     void showRecentProjects();
@@ -144,6 +160,7 @@ private:
         juce::String author = "";
         juce::String version = "1.0.0";
         juce::String description = "";
+        double lengthSeconds = 60.0; // duración del bounce offline
         juce::Time creationDate;
         juce::Time lastModifiedDate;
     } projectProperties;
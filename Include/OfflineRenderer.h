@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "AudioEngine.h"
+#include <functional>
+
+/**
+ * @class OfflineRenderer
+ * @brief Bounce del grafo del AudioEngine a un archivo WAV, más rápido que tiempo real
+ *
+ * render() se ejecuta en un hilo de fondo: toma el grafo del motor (el
+ * dispositivo emite silencio mientras tanto), lo procesa bloque a bloque tan
+ * rápido como permita la CPU y escribe cada bloque en el archivo según sale.
+ * La memoria usada es un único buffer de blockSize muestras, sea cual sea la
+ * duración. Se escribe en un archivo temporal que sólo sustituye al destino
+ * si el render termina, así que cancelar no deja archivos a medias. La
+ * latencia de salida del grafo se descarta al principio del archivo.
+ */
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        double lengthSeconds = 60.0;
+        int bitsPerSample = 24;    // 16, 24 o 32 (float)
+        int blockSize = 4096;
+    };
+
+    struct Statistics
+    {
+        juce::int64 samplesWritten = 0;
+        double elapsedSeconds = 0.0;
+        double realtimeFactor = 0.0; // segundos de audio por segundo de CPU
+        bool wasCancelled = false;
+    };
+
+    explicit OfflineRenderer(AudioEngine& engineToRender);
+
+    /**
+     * Bloquea hasta terminar. progressCallback recibe la fracción completada
+     * (0..1) tras cada bloque y devuelve false para cancelar.
+     */
+    juce::Result render(const juce::File& targetFile, const Settings& settings,
+                        const std::function<bool(double progress)>& progressCallback);
+
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    AudioEngine& engine;
+    Statistics statistics;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+
+#if JUCE_MSVC
+ #include <intrin.h>
+#endif
+
+/**
+ * @class ParameterTable
+ * @brief Tabla de parámetros con IDs estables compartida entre GUI y audio
+ *
+ * Los valores viven en un array contiguo de atómicos que el hilo de audio lee
+ * sin locks. Cada escritura marca además un bit en un bitset jerárquico de
+ * cambios (una palabra resumen por cada 4096 parámetros), de modo que el
+ * hilo de audio sólo visita los parámetros que se movieron en lugar de
+ * recorrer la tabla entera en cada bloque.
+ */
+class ParameterTable
+{
+public:
+    using ParameterID = int;
+
+    static constexpr ParameterID invalidParameterID = -1;
+    static constexpr int maxParameters = 16384;
+
+    ParameterTable();
+
+    // Registro (hilo de mensajes). Una clave ya registrada devuelve el mismo ID
+    // y toma initialValue como valor actual.
+    ParameterID registerParameter(const juce::String& key, float initialValue);
+    ParameterID findParameter(const juce::String& key) const;
+    int getNumParameters() const { return numParameters.load(std::memory_order_acquire); }
+
+    // Escritura desde cualquier hilo, sin locks
+    void setValue(ParameterID parameterID, float newValue) noexcept
+    {
+        if (!isValid(parameterID))
+            return;
+
+        values[static_cast<size_t>(parameterID)].store(newValue, std::memory_order_relaxed);
+
+        const int wordIndex = parameterID >> wordShift;
+        changedWords[static_cast<size_t>(wordIndex)].fetch_or(bitFor(parameterID), std::memory_order_release);
+        summaryWords[static_cast<size_t>(wordIndex >> wordShift)].fetch_or(bitFor(wordIndex), std::memory_order_release);
+    }
+
+    // Guarda el valor sin marcarlo como cambio: para lo que los oyentes ya
+    // recibieron por otra vía (las rampas de automatización), de modo que la
+    // tabla y la GUI no se queden con el valor anterior
+    void storeValue(ParameterID parameterID, float newValue) noexcept
+    {
+        if (isValid(parameterID))
+            values[static_cast<size_t>(parameterID)].store(newValue, std::memory_order_relaxed);
+    }
+
+    float getValue(ParameterID parameterID) const noexcept
+    {
+        return isValid(parameterID) ? values[static_cast<size_t>(parameterID)].load(std::memory_order_relaxed)
+                                    : 0.0f;
+    }
+
+    /**
+     * Hilo de audio: llama a callback(id, valor) para cada parámetro que cambió
+     * desde la última llamada y limpia sus marcas. El coste depende del número
+     * de cambios, no del tamaño de la tabla.
+     */
+    template <typename Callback>
+    void forEachChangedParameter(Callback&& callback) noexcept
+    {
+        for (size_t s = 0; s < summaryWords.size(); ++s)
+        {
+            auto summary = summaryWords[s].exchange(0, std::memory_order_acquire);
+
+            while (summary != 0)
+            {
+                const int wordIndex = static_cast<int>(s << wordShift) + lowestSetBit(summary);
+                summary &= summary - 1;
+
+                auto bits = changedWords[static_cast<size_t>(wordIndex)].exchange(0, std::memory_order_acquire);
+
+                while (bits != 0)
+                {
+                    const ParameterID parameterID = (wordIndex << wordShift) + lowestSetBit(bits);
+                    bits &= bits - 1;
+                    callback(parameterID, values[static_cast<size_t>(parameterID)].load(std::memory_order_relaxed));
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int wordShift = 6;   // 64 bits por palabra
+    static constexpr int numWords = maxParameters >> wordShift;
+    static constexpr int numSummaryWords = numWords >> wordShift;
+
+    bool isValid(ParameterID parameterID) const noexcept
+    {
+        return parameterID >= 0 && parameterID < getNumParameters();
+    }
+
+    static juce::uint64 bitFor(int index) noexcept
+    {
+        return juce::uint64(1) << (index & ((1 << wordShift) - 1));
+    }
+
+    static int lowestSetBit(juce::uint64 bits) noexcept
+    {
+       #if JUCE_MSVC
+        unsigned long index = 0;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+       #else
+        return __builtin_ctzll(bits);
+       #endif
+    }
+
+    std::unique_ptr<std::atomic<float>[]> values;
+    std::array<std::atomic<juce::uint64>, numWords> changedWords;
+    std::array<std::atomic<juce::uint64>, numSummaryWords> summaryWords;
+    std::atomic<int> numParameters { 0 };
+
+    // Claves -> IDs (sólo para el registro, nunca en el hilo de audio)
+    juce::CriticalSection registryLock;
+    std::map<juce::String, ParameterID> idsByKey;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterTable)
+};
@@ -0,0 +1,194 @@
+#include "AudioCallbackMonitor.h"
+
+AudioCallbackMonitor::AudioCallbackMonitor()
+{
+    secondsPerTick = 1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    clearStatistics();
+}
+
+void AudioCallbackMonitor::prepare(double sampleRate)
+{
+    currentSampleRate.store(sampleRate, std::memory_order_relaxed);
+    resetRequested.store(false, std::memory_order_relaxed);
+    clearStatistics();
+}
+
+void AudioCallbackMonitor::reset()
+{
+    // Lo ejecuta el propio hilo de audio en el siguiente callback: así sigue
+    // siendo el único escritor del peor bloque
+    resetRequested.store(true, std::memory_order_release);
+}
+
+void AudioCallbackMonitor::clearStatistics() noexcept
+{
+    numCallbacks.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    lastLoad.store(0.0, std::memory_order_relaxed);
+    loadSum.store(0.0, std::memory_order_relaxed);
+
+    for (auto& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+
+    worstVersion.fetch_add(1, std::memory_order_acq_rel);
+    worstLoad.store(0.0, std::memory_order_relaxed);
+    worstDurationMs.store(0.0, std::memory_order_relaxed);
+    worstDeadlineMs.store(0.0, std::memory_order_relaxed);
+    worstNumSamples.store(0, std::memory_order_relaxed);
+    worstCallbackIndex.store(0, std::memory_order_relaxed);
+    worstWallClockMillis.store(0, std::memory_order_relaxed);
+    worstVersion.fetch_add(1, std::memory_order_release);
+}
+
+void AudioCallbackMonitor::recordCallback(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept
+{
+    const auto sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+
+    if (sampleRate <= 0.0 || numSamples <= 0)
+        return;
+
+    if (resetRequested.exchange(false, std::memory_order_acquire))
+        clearStatistics();
+
+    const double durationSeconds = static_cast<double>(endTicks - startTicks) * secondsPerTick;
+    const double deadlineSeconds = numSamples / sampleRate;
+    const double load = durationSeconds / deadlineSeconds;
+
+    const auto callbackIndex = numCallbacks.load(std::memory_order_relaxed) + 1;
+    numCallbacks.store(callbackIndex, std::memory_order_relaxed);
+    lastLoad.store(load, std::memory_order_relaxed);
+    loadSum.store(loadSum.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+
+    const int bucket = juce::jlimit(0, numBuckets - 1, static_cast<int>(load * 100.0 / bucketWidthPercent));
+    histogram[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+
+    if (load > 1.0)
+        numOverruns.fetch_add(1, std::memory_order_relaxed);
+
+    if (load > worstLoad.load(std::memory_order_relaxed))
+    {
+        worstVersion.fetch_add(1, std::memory_order_acq_rel);
+        worstLoad.store(load, std::memory_order_relaxed);
+        worstDurationMs.store(durationSeconds * 1000.0, std::memory_order_relaxed);
+        worstDeadlineMs.store(deadlineSeconds * 1000.0, std::memory_order_relaxed);
+        worstNumSamples.store(numSamples, std::memory_order_relaxed);
+        worstCallbackIndex.store(callbackIndex, std::memory_order_relaxed);
+        worstWallClockMillis.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+        worstVersion.fetch_add(1, std::memory_order_release);
+    }
+}
+
+AudioCallbackMonitor::Snapshot AudioCallbackMonitor::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+
+    // Reinicio pendiente: las estadísticas viejas ya no cuentan
+    if (resetRequested.load(std::memory_order_acquire))
+        return snapshot;
+
+    snapshot.numCallbacks = numCallbacks.load(std::memory_order_relaxed);
+    snapshot.numOverruns = numOverruns.load(std::memory_order_relaxed);
+    snapshot.lastLoadPercent = lastLoad.load(std::memory_order_relaxed) * 100.0;
+
+    if (snapshot.numCallbacks > 0)
+        snapshot.averageLoadPercent = loadSum.load(std::memory_order_relaxed) * 100.0
+                                        / static_cast<double>(snapshot.numCallbacks);
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        snapshot.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+
+    // Reintentar hasta leer un peor bloque coherente
+    for (;;)
+    {
+        const auto versionBefore = worstVersion.load(std::memory_order_acquire);
+
+        if ((versionBefore & 1) == 0)
+        {
+            snapshot.worst.durationMs = worstDurationMs.load(std::memory_order_relaxed);
+            snapshot.worst.deadlineMs = worstDeadlineMs.load(std::memory_order_relaxed);
+            snapshot.worst.numSamples = worstNumSamples.load(std::memory_order_relaxed);
+            snapshot.worst.callbackIndex = worstCallbackIndex.load(std::memory_order_relaxed);
+            snapshot.worst.wallClockMillis = worstWallClockMillis.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (worstVersion.load(std::memory_order_relaxed) == versionBefore)
+                break;
+        }
+
+        juce::Thread::yield();
+    }
+
+    return snapshot;
+}
+
+//==============================================================================
+juce::String AudioCallbackMonitor::describe(const Snapshot& snapshot, int deviceXRuns)
+{
+    juce::String text;
+    text << "Callbacks: " << juce::String(snapshot.numCallbacks)
+         << " | carga media " << juce::String(snapshot.averageLoadPercent, 1) << "%"
+         << " | ultima " << juce::String(snapshot.lastLoadPercent, 1) << "%" << juce::newLine;
+
+    text << "Excesos de plazo (DSP): " << juce::String(snapshot.numOverruns)
+         << " | xruns del dispositivo: " << (deviceXRuns >= 0 ? juce::String(deviceXRuns) : juce::String("n/d"))
+         << juce::newLine;
+
+    if (snapshot.worst.callbackIndex > 0)
+    {
+        text << "Peor bloque: " << juce::String(snapshot.worst.durationMs, 3) << " ms de "
+             << juce::String(snapshot.worst.deadlineMs, 3) << " ms ("
+             << juce::String(snapshot.worst.numSamples) << " muestras, callback #"
+             << juce::String(snapshot.worst.callbackIndex) << ", "
+             << juce::Time(snapshot.worst.wallClockMillis).toString(true, true, true, true) << ")"
+             << juce::newLine;
+    }
+
+    text << "Histograma de carga:" << juce::newLine;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        const auto count = snapshot.histogram[static_cast<size_t>(i)];
+
+        if (count == 0)
+            continue;
+
+        const auto from = juce::String(static_cast<int>(i * bucketWidthPercent));
+        const auto label = (i == numBuckets - 1) ? ">= " + from + "%"
+                                                 : from + "-" + juce::String(static_cast<int>((i + 1) * bucketWidthPercent)) + "%";
+
+        text << "  " << label << ": " << juce::String(count) << juce::newLine;
+    }
+
+    return text;
+}
+
+juce::String AudioCallbackMonitor::toCSV(const Snapshot& snapshot, int deviceXRuns)
+{
+    juce::String csv;
+    csv << "metric,value" << juce::newLine
+        << "sample_rate," << juce::String(snapshot.sampleRate) << juce::newLine
+        << "callbacks," << juce::String(snapshot.numCallbacks) << juce::newLine
+        << "dsp_overruns," << juce::String(snapshot.numOverruns) << juce::newLine
+        << "device_xruns," << juce::String(deviceXRuns) << juce::newLine
+        << "average_load_percent," << juce::String(snapshot.averageLoadPercent, 3) << juce::newLine
+        << "worst_duration_ms," << juce::String(snapshot.worst.durationMs, 4) << juce::newLine
+        << "worst_deadline_ms," << juce::String(snapshot.worst.deadlineMs, 4) << juce::newLine
+        << "worst_num_samples," << juce::String(snapshot.worst.numSamples) << juce::newLine
+        << "worst_callback_index," << juce::String(snapshot.worst.callbackIndex) << juce::newLine
+        << "worst_timestamp," << juce::Time(snapshot.worst.wallClockMillis).toISO8601(true) << juce::newLine
+        << juce::newLine
+        << "load_from_percent,load_to_percent,count" << juce::newLine;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        const auto to = (i == numBuckets - 1) ? juce::String("inf")
+                                              : juce::String(static_cast<int>((i + 1) * bucketWidthPercent));
+
+        csv << juce::String(static_cast<int>(i * bucketWidthPercent)) << "," << to << ","
+            << juce::String(snapshot.histogram[static_cast<size_t>(i)]) << juce::newLine;
+    }
+
+    return csv;
+}
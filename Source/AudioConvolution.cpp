@@ -0,0 +1,902 @@
+#include "AudioConvolution.h"
+#include "AudioSimd.h"
+#include "AudioSpinWait.h"
+#include "AudioThreadTrap.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // Tamaños de partición de la cola; cada tramo empieza en el doble de su
+    // tamaño, de modo que el trabajador tiene un bloque entero de margen
+    constexpr int tailPartitionSizes[] = { 1024, 8192 };
+    constexpr int numTailSegments = static_cast<int>(sizeof(tailPartitionSizes) / sizeof(tailPartitionSizes[0]));
+    constexpr int headLength = 2 * tailPartitionSizes[0];
+
+    // Remuestreo del IR: sinc con ventana de Blackman, tabulada
+    constexpr int resamplerZeroCrossings = 32;
+    constexpr int resamplerTableResolution = 512;   // puntos por paso por cero
+
+    std::vector<float> makeResamplerTable()
+    {
+        constexpr auto pi = juce::MathConstants<double>::pi;
+        const int size = resamplerZeroCrossings * resamplerTableResolution + 2;
+        std::vector<float> table(static_cast<size_t>(size));
+
+        for (int i = 0; i < size; ++i)
+        {
+            const double x = static_cast<double>(i) / resamplerTableResolution;
+            const double u = juce::jmin(1.0, x / resamplerZeroCrossings);
+            const double window = 0.42 + 0.5 * std::cos(pi * u) + 0.08 * std::cos(2.0 * pi * u);
+            const double sinc = i == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+            table[static_cast<size_t>(i)] = static_cast<float>(sinc * window);
+        }
+
+        return table;
+    }
+
+    // ratio = frecuencia de salida / de entrada. Al bajar de frecuencia filtra
+    // por debajo del nuevo Nyquist. El factor 1 / ratio conserva la respuesta
+    // del IR: a otra frecuencia la suma de la convolución tiene otro número de
+    // términos.
+    void resampleChannel(const float* input, int inputLength, float* output, int outputLength,
+                         double ratio, const std::vector<float>& table)
+    {
+        const double cutoff = juce::jmin(1.0, ratio);
+        const double halfWidth = resamplerZeroCrossings / cutoff;
+        const double tableScale = cutoff * resamplerTableResolution;
+        const double gain = cutoff / ratio;
+
+        for (int m = 0; m < outputLength; ++m)
+        {
+            const double centre = m / ratio;
+            const int first = juce::jmax(0, static_cast<int>(std::ceil(centre - halfWidth)));
+            const int last = juce::jmin(inputLength - 1, static_cast<int>(std::floor(centre + halfWidth)));
+            double sum = 0.0;
+
+            for (int n = first; n <= last; ++n)
+            {
+                const double position = std::abs(centre - n) * tableScale;
+                const auto index = static_cast<size_t>(position);
+                const double fraction = position - static_cast<double>(index);
+                sum += input[n] * (table[index] + fraction * (table[index + 1] - table[index]));
+            }
+
+            output[m] = static_cast<float>(sum * gain);
+        }
+    }
+
+    int log2OfPowerOfTwo(int value) noexcept
+    {
+        int order = 0;
+
+        while ((1 << order) < value)
+            ++order;
+
+        return order;
+    }
+}
+
+//==============================================================================
+// Source: la última petición de carga, a la frecuencia original del IR
+//==============================================================================
+struct AudioConvolution::Source
+{
+    juce::File file;                            // si no está vacío se lee en el hilo de carga
+    juce::AudioBuffer<float> impulseResponse;
+    double sampleRate = 0.0;
+    bool normalise = true;
+};
+
+//==============================================================================
+// Engine: un IR ya partido y transformado, con todo su estado de convolución
+//==============================================================================
+class AudioConvolution::Engine
+{
+public:
+    Engine(const juce::AudioBuffer<float>& impulseResponse, int channels)
+        : numChannels(channels)
+    {
+        const int length = impulseResponse.getNumSamples();
+
+        if (length == 0 || impulseResponse.getNumChannels() == 0)
+            return;
+
+        segments.push_back(std::make_unique<Segment>(impulseResponse, headBlockSize, 0,
+                                                     juce::jmin(length, headLength), channels, false));
+
+        for (int i = 0; i < numTailSegments; ++i)
+        {
+            const int partitionSize = tailPartitionSizes[i];
+            const int start = 2 * partitionSize;
+            const int end = i + 1 < numTailSegments ? 2 * tailPartitionSizes[i + 1] : length;
+
+            if (length <= start)
+                break;
+
+            segments.push_back(std::make_unique<Segment>(impulseResponse, partitionSize, start,
+                                                         juce::jmin(length, end) - start, channels, true));
+        }
+    }
+
+    // Hilo de carga o prepare(): remuestrea, recorta y normaliza el IR y lo transforma
+    static std::unique_ptr<Engine> create(const Source& source, double sampleRate, int channels)
+    {
+        const auto& original = source.impulseResponse;
+        const int irChannels = juce::jmin(original.getNumChannels(), maxChannels);
+
+        if (irChannels == 0 || original.getNumSamples() == 0 || source.sampleRate <= 0.0)
+            return std::make_unique<Engine>(juce::AudioBuffer<float>(), channels);
+
+        const double ratio = sampleRate / source.sampleRate;
+        const int inputLength = juce::jmin(original.getNumSamples(),
+                                           static_cast<int>(std::ceil(maxImpulseResponseSeconds * source.sampleRate)));
+        const int length = juce::jmin(static_cast<int>(std::ceil(inputLength * ratio)),
+                                      static_cast<int>(std::ceil(maxImpulseResponseSeconds * sampleRate)));
+
+        juce::AudioBuffer<float> impulseResponse(irChannels, length);
+
+        if (length == inputLength)
+        {
+            for (int ch = 0; ch < irChannels; ++ch)
+                impulseResponse.copyFrom(ch, 0, original, ch, 0, length);
+        }
+        else
+        {
+            const auto table = makeResamplerTable();
+
+            for (int ch = 0; ch < irChannels; ++ch)
+                resampleChannel(original.getReadPointer(ch), inputLength,
+                                impulseResponse.getWritePointer(ch), length, ratio, table);
+        }
+
+        // Energía unidad en el canal más fuerte: los IR de distintas fuentes suenan parecido
+        if (source.normalise)
+        {
+            double maxEnergy = 0.0;
+
+            for (int ch = 0; ch < irChannels; ++ch)
+            {
+                const auto* samples = impulseResponse.getReadPointer(ch);
+                double energy = 0.0;
+
+                for (int i = 0; i < length; ++i)
+                    energy += static_cast<double>(samples[i]) * samples[i];
+
+                maxEnergy = juce::jmax(maxEnergy, energy);
+            }
+
+            if (maxEnergy > 0.0)
+                impulseResponse.applyGain(static_cast<float>(1.0 / std::sqrt(maxEnergy)));
+        }
+
+        return std::make_unique<Engine>(impulseResponse, channels);
+    }
+
+    // Sólo sin bloques de cola pendientes
+    void reset() noexcept
+    {
+        for (auto& segment : segments)
+            segment->reset();
+
+        blockIndex = 0;
+    }
+
+    // Hilo de audio: suma a wet la convolución del bloque de cabeza recién completado
+    void processBlock(AudioConvolution& owner, const float* const* input, float* const* wet, int channels) noexcept
+    {
+        if (segments.empty())
+            return;
+
+        const auto position = blockIndex * headBlockSize;
+        auto& head = *segments.front();
+
+        for (auto& segment : segments)
+        {
+            const auto offset = static_cast<int>(position % (segment->historyChunks * segment->blockSize));
+
+            for (int ch = 0; ch < channels; ++ch)
+                std::memcpy(segment->history(ch) + offset, input[ch], sizeof(float) * headBlockSize);
+        }
+
+        head.convolve(blockIndex);
+
+        for (int ch = 0; ch < channels; ++ch)
+            juce::FloatVectorOperations::add(wet[ch], head.outputChunk(ch, 0), headBlockSize);
+
+        // Salida de la cola para estas mismas muestras; se lee antes de encolar
+        // nada, porque un bloque nuevo escribe donde se lee el penúltimo
+        for (size_t s = 1; s < segments.size(); ++s)
+        {
+            auto& segment = *segments[s];
+
+            if (position < segment.offset)
+                continue;
+
+            const auto relative = position - segment.offset;
+            const auto chunk = relative / segment.blockSize;
+            const auto offset = static_cast<int>(relative % segment.blockSize);
+
+            if (offset == 0)
+                owner.waitForTailJob(segment.jobSlots[static_cast<size_t>(chunk & 1)], segment.completedChunks, chunk);
+
+            for (int ch = 0; ch < channels; ++ch)
+                juce::FloatVectorOperations::add(wet[ch], segment.outputChunk(ch, chunk) + offset, headBlockSize);
+        }
+
+        const auto inputEnd = position + headBlockSize;
+
+        for (size_t s = 1; s < segments.size(); ++s)
+        {
+            auto& segment = *segments[s];
+
+            if (inputEnd % segment.blockSize == 0)
+            {
+                const auto chunk = inputEnd / segment.blockSize - 1;
+                segment.jobSlots[static_cast<size_t>(chunk & 1)] = owner.postTailJob(*this, static_cast<int>(s), chunk);
+            }
+        }
+
+        ++blockIndex;
+    }
+
+    // Trabajador o hilo de audio, con el bloque ya reclamado
+    void runTailJob(int segmentIndex, juce::int64 chunk) noexcept
+    {
+        auto& segment = *segments[static_cast<size_t>(segmentIndex)];
+
+        // Los bloques de un tramo comparten la línea de retardo: van en orden
+        while (segment.completedChunks.load(std::memory_order_acquire) < chunk)
+            AudioSpinWait::pause();
+
+        segment.convolve(chunk);
+        segment.completedChunks.store(chunk + 1, std::memory_order_release);
+    }
+
+    // Bloques encolados y aún sin terminar; a cero el motor se puede liberar
+    std::atomic<int> outstandingJobs { 0 };
+
+private:
+    /**
+     * Particiones uniformes de blockSize muestras del IR a partir de offset,
+     * por solapamiento-descarte: cada bloque de entrada se transforma una vez
+     * junto con el anterior (FFT de 2 * blockSize) y entra en una línea de
+     * retardo de espectros que se multiplica por los de las particiones.
+     */
+    struct Segment
+    {
+        Segment(const juce::AudioBuffer<float>& impulseResponse, int partitionSize, int start,
+                int length, int channels, bool isTail)
+            : blockSize(partitionSize),
+              offset(start),
+              numPartitions((length + partitionSize - 1) / partitionSize),
+              stride(AudioSimd::spectrumStride(partitionSize + 1)),
+              numChannels(channels),
+              irChannels(impulseResponse.getNumChannels()),
+              historyChunks(isTail ? 4 : 2),
+              outputChunks(isTail ? 2 : 1),
+              fft(log2OfPowerOfTwo(2 * partitionSize))
+        {
+            impulseSpectra.resize(static_cast<size_t>(irChannels * numPartitions * 2 * stride));
+            inputSpectra.resize(static_cast<size_t>(numChannels * numPartitions * 2 * stride));
+            inputHistory.resize(static_cast<size_t>(numChannels * historyChunks * blockSize));
+            output.resize(static_cast<size_t>(numChannels * outputChunks * blockSize));
+            fftBuffer.resize(static_cast<size_t>(4 * blockSize));
+            accumulator.resize(static_cast<size_t>(2 * stride));
+
+            for (int ch = 0; ch < irChannels; ++ch)
+            {
+                for (int k = 0; k < numPartitions; ++k)
+                {
+                    const int first = start + k * blockSize;
+                    const int count = juce::jmin(blockSize, start + length - first);
+
+                    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+                    std::memcpy(fftBuffer.data(), impulseResponse.getReadPointer(ch, first), sizeof(float) * static_cast<size_t>(count));
+                    fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+                    split(fftBuffer.data(), impulseSpectrum(ch, k));
+                }
+            }
+        }
+
+        void reset() noexcept
+        {
+            std::fill(inputSpectra.begin(), inputSpectra.end(), 0.0f);
+            std::fill(inputHistory.begin(), inputHistory.end(), 0.0f);
+            std::fill(output.begin(), output.end(), 0.0f);
+            spectraPosition = 0;
+            completedChunks.store(0, std::memory_order_relaxed);
+        }
+
+        float* history(int channel) noexcept
+        {
+            return inputHistory.data() + static_cast<size_t>(channel * historyChunks * blockSize);
+        }
+
+        float* outputChunk(int channel, juce::int64 chunk) noexcept
+        {
+            const auto slot = static_cast<int>(chunk % outputChunks);
+            return output.data() + static_cast<size_t>((channel * outputChunks + slot) * blockSize);
+        }
+
+        float* impulseSpectrum(int irChannel, int partition) noexcept
+        {
+            return impulseSpectra.data() + static_cast<size_t>((irChannel * numPartitions + partition) * 2 * stride);
+        }
+
+        float* inputSpectrum(int channel, int slot) noexcept
+        {
+            return inputSpectra.data() + static_cast<size_t>((channel * numPartitions + slot) * 2 * stride);
+        }
+
+        // Formato intercalado de juce::dsp::FFT (blockSize + 1 bins) a partido
+        void split(const float* interleaved, float* spectrum) const noexcept
+        {
+            for (int bin = 0; bin <= blockSize; ++bin)
+            {
+                spectrum[bin] = interleaved[2 * bin];
+                spectrum[stride + bin] = interleaved[2 * bin + 1];
+            }
+        }
+
+        void interleave(const float* spectrum, float* interleaved) const noexcept
+        {
+            for (int bin = 0; bin <= blockSize; ++bin)
+            {
+                interleaved[2 * bin] = spectrum[bin];
+                interleaved[2 * bin + 1] = spectrum[stride + bin];
+            }
+        }
+
+        // Bloque de salida número chunk: entrada [chunk - 1, chunk] contra todas las particiones
+        void convolve(juce::int64 chunk) noexcept
+        {
+            using AudioSimd::Vec;
+
+            const auto previous = static_cast<int>((chunk + historyChunks - 1) % historyChunks);
+            const auto current = static_cast<int>(chunk % historyChunks);
+            auto* buffer = fftBuffer.data();
+            auto* accumulatorReal = accumulator.data();
+            auto* accumulatorImag = accumulatorReal + stride;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* input = history(ch);
+                std::memcpy(buffer, input + previous * blockSize, sizeof(float) * static_cast<size_t>(blockSize));
+                std::memcpy(buffer + blockSize, input + current * blockSize, sizeof(float) * static_cast<size_t>(blockSize));
+                fft.performRealOnlyForwardTransform(buffer, true);
+                split(buffer, inputSpectrum(ch, spectraPosition));
+
+                const int irChannel = ch % irChannels;
+
+                for (int k = 0; k < numPartitions; ++k)
+                {
+                    const int slot = (spectraPosition - k + numPartitions) % numPartitions;
+                    const auto* x = inputSpectrum(ch, slot);
+                    const auto* h = impulseSpectrum(irChannel, k);
+
+                    for (int bin = 0; bin < stride; bin += Vec::width)
+                    {
+                        Vec real, imag;
+                        AudioSimd::complexMultiply(Vec::load(x + bin), Vec::load(x + stride + bin),
+                                                   Vec::load(h + bin), Vec::load(h + stride + bin), real, imag);
+
+                        if (k > 0)
+                        {
+                            real = real + Vec::load(accumulatorReal + bin);
+                            imag = imag + Vec::load(accumulatorImag + bin);
+                        }
+
+                        real.store(accumulatorReal + bin);
+                        imag.store(accumulatorImag + bin);
+                    }
+                }
+
+                interleave(accumulatorReal, buffer);
+                fft.performRealOnlyInverseTransform(buffer);
+                std::memcpy(outputChunk(ch, chunk), buffer + blockSize, sizeof(float) * static_cast<size_t>(blockSize));
+            }
+
+            spectraPosition = (spectraPosition + 1) % numPartitions;
+        }
+
+        const int blockSize;
+        const int offset;
+        const int numPartitions;
+        const int stride;               // bins por mitad de espectro, redondeado
+        const int numChannels;
+        const int irChannels;
+        const int historyChunks;        // cabeza: 2; cola: 4 (uno en cálculo, dos de ventana, uno llenándose)
+        const int outputChunks;         // cabeza: 1; cola: 2 (uno leyéndose, otro en cálculo)
+        juce::dsp::FFT fft;
+
+        std::vector<float> impulseSpectra;  // [canal del IR][partición][reales | imaginarios]
+        std::vector<float> inputSpectra;    // [canal][ranura], línea de retardo en frecuencia
+        std::vector<float> inputHistory;    // [canal][historyChunks * blockSize]
+        std::vector<float> output;          // [canal][outputChunks * blockSize]
+        std::vector<float> fftBuffer;       // 2 * tamaño de la FFT
+        std::vector<float> accumulator;
+        int spectraPosition = 0;
+
+        // Sólo cola
+        std::array<int, 2> jobSlots {};     // ranura de TailJob por paridad del bloque (hilo de audio)
+        std::atomic<juce::int64> completedChunks { 0 };
+    };
+
+    const int numChannels;
+    std::vector<std::unique_ptr<Segment>> segments;     // [0] es la cabeza
+    juce::int64 blockIndex = 0;                         // bloques de cabeza procesados (hilo de audio)
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Engine)
+};
+
+//==============================================================================
+// TailWorker: calcula los bloques de la cola que encola el hilo de audio
+//==============================================================================
+class AudioConvolution::TailWorker : public juce::Thread
+{
+public:
+    explicit TailWorker(AudioConvolution& ownerToUse)
+        : juce::Thread("Convolution Tail Worker"), owner(ownerToUse) {}
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            int slot = -1;
+
+            {
+                auto scope = owner.tailJobFifo.read(juce::jmin(1, owner.tailJobFifo.getNumReady()));
+                scope.forEach([this, &slot](int index) { slot = owner.queuedTailJobs[static_cast<size_t>(index)]; });
+            }
+
+            // Si el hilo de audio ya lo ha reclamado, la entrada sólo se descarta
+            if (slot >= 0)
+            {
+                owner.tryRunTailJob(slot);
+                continue;
+            }
+
+            // Aparcar: el hilo de audio mira 'parked' después de encolar
+            parked.store(true, std::memory_order_seq_cst);
+
+            if (owner.tailJobFifo.getNumReady() == 0)
+                wait(10);
+
+            parked.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<bool> parked { false };
+
+private:
+    AudioConvolution& owner;
+};
+
+//==============================================================================
+// Loader: lee, remuestrea y transforma los IR fuera del hilo de mensajes
+//==============================================================================
+class AudioConvolution::Loader : public juce::Thread
+{
+public:
+    explicit Loader(AudioConvolution& ownerToUse)
+        : juce::Thread("Convolution IR Loader"), owner(ownerToUse) {}
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            owner.serviceLoadRequest();
+            wait(-1);
+        }
+    }
+
+private:
+    AudioConvolution& owner;
+};
+
+//==============================================================================
+AudioConvolution::AudioConvolution()
+    : worker(std::make_unique<TailWorker>(*this)),
+      loader(std::make_unique<Loader>(*this))
+{
+    loader->startThread();
+    startTimer(200);
+}
+
+AudioConvolution::~AudioConvolution()
+{
+    stopTimer();
+
+    loader->signalThreadShouldExit();
+    loader->notify();
+    loader->stopThread(10000);
+
+    stopAndDeleteEngines();
+}
+
+void AudioConvolution::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    std::shared_ptr<const Source> source;
+
+    {
+        const juce::ScopedLock sl(requestLock);
+        sampleRate = spec.sampleRate;
+        numChannels = juce::jlimit(1, maxChannels, static_cast<int>(spec.numChannels));
+        ++specGeneration;   // lo que esté construyendo el hilo de carga ya no sirve
+        source = currentSource;
+    }
+
+    // Después de cambiar la generación: un motor de la configuración anterior
+    // que el hilo de carga publicara antes se borra aquí, y ya no puede
+    // publicar ninguno más
+    stopAndDeleteEngines();
+
+    for (auto* buffer : { &headInput, &headOutput, &headWet, &headFade })
+    {
+        buffer->setSize(numChannels, headBlockSize);
+        buffer->clear();
+    }
+
+    blockPosition = 0;
+    fadePosition = crossfadeSamples;
+    mix.prepare(sampleRate);
+
+    if (source != nullptr)
+        activeEngine = Engine::create(*source, sampleRate, numChannels).release();
+
+    worker->startThread(juce::Thread::Priority::high);
+}
+
+void AudioConvolution::reset()
+{
+    // Sólo con el callback detenido: espera a que el trabajador acabe lo encolado
+    for (auto* engine : { activeEngine, fadingEngine, drainingEngine })
+        if (engine != nullptr)
+            while (engine->outstandingJobs.load(std::memory_order_acquire) > 0)
+                juce::Thread::sleep(1);
+
+    delete fadingEngine;
+    delete drainingEngine;
+    fadingEngine = nullptr;
+    drainingEngine = nullptr;
+    fadePosition = crossfadeSamples;
+
+    if (activeEngine != nullptr)
+        activeEngine->reset();
+
+    for (auto* buffer : { &headInput, &headOutput, &headWet, &headFade })
+        buffer->clear();
+
+    blockPosition = 0;
+    mix.setCurrentAndTargetValue(mix.getTargetValue());
+}
+
+void AudioConvolution::stopAndDeleteEngines()
+{
+    worker->signalThreadShouldExit();
+    worker->notify();
+    worker->stopThread(1000);
+
+    reclaimRetiredEngines();
+    delete pendingEngine.exchange(nullptr);
+
+    for (auto** engine : { &activeEngine, &fadingEngine, &drainingEngine })
+    {
+        delete *engine;
+        *engine = nullptr;
+    }
+
+    // Sin trabajador ya nadie ejecuta lo que quedara encolado
+    tailJobFifo.reset();
+
+    for (auto& job : tailJobs)
+        job.state.store(TailJob::kFree, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void AudioConvolution::loadImpulseResponse(const juce::File& file, bool normalise)
+{
+    auto request = std::make_unique<Source>();
+    request->file = file;
+    request->normalise = normalise;
+
+    {
+        const juce::ScopedLock sl(requestLock);
+        queuedRequest = std::move(request);
+    }
+
+    loader->notify();
+}
+
+void AudioConvolution::loadImpulseResponse(juce::AudioBuffer<float> impulseResponse, double impulseResponseSampleRate, bool normalise)
+{
+    auto request = std::make_unique<Source>();
+    request->impulseResponse = std::move(impulseResponse);
+    request->sampleRate = impulseResponseSampleRate;
+    request->normalise = normalise;
+
+    {
+        const juce::ScopedLock sl(requestLock);
+        queuedRequest = std::move(request);
+    }
+
+    loader->notify();
+}
+
+void AudioConvolution::clearImpulseResponse()
+{
+    // Un IR vacío: el motor nuevo no suena y el fundido apaga el anterior
+    loadImpulseResponse(juce::AudioBuffer<float>(), 0.0);
+}
+
+void AudioConvolution::serviceLoadRequest()
+{
+    std::unique_ptr<Source> request;
+
+    {
+        const juce::ScopedLock sl(requestLock);
+        request = std::move(queuedRequest);
+    }
+
+    if (request == nullptr)
+        return;
+
+    if (request->file != juce::File())
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(request->file));
+
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+            return;
+
+        const auto length = static_cast<int>(juce::jmin(reader->lengthInSamples,
+                                                        static_cast<juce::int64>(maxImpulseResponseSeconds * reader->sampleRate)));
+        const auto channels = juce::jmin(static_cast<int>(reader->numChannels), maxChannels);
+
+        request->impulseResponse.setSize(channels, length);
+        reader->read(&request->impulseResponse, 0, length, 0, true, true);
+        request->sampleRate = reader->sampleRate;
+    }
+
+    std::shared_ptr<const Source> source(std::move(request));
+    double rate = 0.0;
+    int channels = 0;
+    int generation = 0;
+
+    {
+        const juce::ScopedLock sl(requestLock);
+        currentSource = source;
+        rate = sampleRate;
+        channels = numChannels;
+        generation = specGeneration;
+    }
+
+    // Aún sin preparar: prepare() construirá el motor
+    if (channels == 0)
+        return;
+
+    auto engine = Engine::create(*source, rate, channels);
+
+    const juce::ScopedLock sl(requestLock);
+
+    if (generation == specGeneration)
+        publish(std::move(engine));
+}
+
+void AudioConvolution::publish(std::unique_ptr<Engine> engine)
+{
+    std::unique_ptr<Engine> neverUsed(pendingEngine.exchange(engine.release(), std::memory_order_acq_rel));
+}
+
+void AudioConvolution::timerCallback()
+{
+    reclaimRetiredEngines();
+}
+
+void AudioConvolution::reclaimRetiredEngines()
+{
+    auto scope = retiredFifo.read(retiredFifo.getNumReady());
+    scope.forEach([this](int index)
+    {
+        auto& slot = retiredEngines[static_cast<size_t>(index)];
+        delete slot;
+        slot = nullptr;
+    });
+}
+
+//==============================================================================
+void AudioConvolution::processSamples(const float* const* inputs, float* const* outputs, int channels, int numSamples) noexcept
+{
+    // Entrada y salida pueden ser el mismo buffer: cada trozo se lee antes de escribirlo
+    for (int done = 0; done < numSamples;)
+    {
+        const int count = juce::jmin(numSamples - done, headBlockSize - blockPosition);
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            std::memcpy(headInput.getWritePointer(ch, blockPosition), inputs[ch] + done, sizeof(float) * static_cast<size_t>(count));
+            std::memcpy(outputs[ch] + done, headOutput.getReadPointer(ch, blockPosition), sizeof(float) * static_cast<size_t>(count));
+        }
+
+        blockPosition += count;
+        done += count;
+
+        if (blockPosition == headBlockSize)
+        {
+            processHeadBlock(channels);
+            blockPosition = 0;
+        }
+    }
+}
+
+void AudioConvolution::processHeadBlock(int channels) noexcept
+{
+    using AudioSimd::Vec;
+
+    if (drainingEngine != nullptr
+        && drainingEngine->outstandingJobs.load(std::memory_order_acquire) == 0
+        && retiredFifo.getFreeSpace() > 0)
+    {
+        auto scope = retiredFifo.write(1);
+        scope.forEach([this](int index) { retiredEngines[static_cast<size_t>(index)] = drainingEngine; });
+        drainingEngine = nullptr;
+    }
+
+    adoptPendingEngine();
+
+    const auto* const* input = headInput.getArrayOfReadPointers();
+    auto* const* wet = headWet.getArrayOfWritePointers();
+
+    for (int ch = 0; ch < channels; ++ch)
+        juce::FloatVectorOperations::clear(wet[ch], headBlockSize);
+
+    if (activeEngine != nullptr)
+        activeEngine->processBlock(*this, input, wet, channels);
+
+    // Fundido lineal desde el motor anterior (o desde silencio con el primer IR)
+    if (fadePosition < crossfadeSamples)
+    {
+        auto* const* fade = headFade.getArrayOfWritePointers();
+
+        for (int ch = 0; ch < channels; ++ch)
+            juce::FloatVectorOperations::clear(fade[ch], headBlockSize);
+
+        if (fadingEngine != nullptr)
+            fadingEngine->processBlock(*this, input, fade, channels);
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            for (int i = 0; i < headBlockSize; ++i)
+            {
+                const auto amount = static_cast<float>(fadePosition + i + 1) / static_cast<float>(crossfadeSamples);
+                wet[ch][i] = fade[ch][i] + amount * (wet[ch][i] - fade[ch][i]);
+            }
+        }
+
+        fadePosition += headBlockSize;
+
+        if (fadePosition >= crossfadeSamples)
+        {
+            drainingEngine = fadingEngine;
+            fadingEngine = nullptr;
+        }
+    }
+
+    auto* const* output = headOutput.getArrayOfWritePointers();
+
+    for (int i = 0; i < headBlockSize; i += Vec::width)
+    {
+        const auto amount = mix.nextFrame(Vec::width);
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            const auto dry = Vec::load(input[ch] + i);
+            (dry + amount * (Vec::load(wet[ch] + i) - dry)).store(output[ch] + i);
+        }
+    }
+}
+
+void AudioConvolution::adoptPendingEngine() noexcept
+{
+    // Un cambio cada vez: el anterior tiene que haber terminado de fundirse y de vaciarse
+    if (fadePosition < crossfadeSamples || drainingEngine != nullptr)
+        return;
+
+    if (auto* next = pendingEngine.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        fadingEngine = activeEngine;
+        activeEngine = next;
+        fadePosition = 0;
+    }
+}
+
+int AudioConvolution::postTailJob(Engine& engine, int segment, juce::int64 chunk) noexcept
+{
+    engine.outstandingJobs.fetch_add(1, std::memory_order_relaxed);
+
+    // Un bloque que no entra en la cola sólo lo calcularía waitForTailJob(), y
+    // un motor que se está vaciando ya no lo llama: con la cola llena se
+    // calcula aquí. Sólo este hilo escribe, así que el hueco no desaparece.
+    for (int attempt = 0; attempt < 2 && tailJobFifo.getFreeSpace() > 0; ++attempt)
+    {
+        for (int slot = 0; slot < maxTailJobs; ++slot)
+        {
+            auto& job = tailJobs[static_cast<size_t>(slot)];
+
+            if (job.state.load(std::memory_order_acquire) != TailJob::kFree)
+                continue;
+
+            job.engine = &engine;
+            job.segment = segment;
+            job.chunk = chunk;
+            job.state.store(TailJob::kQueued, std::memory_order_release);
+
+            {
+                auto scope = tailJobFifo.write(1);
+                scope.forEach([this, slot](int index) { queuedTailJobs[static_cast<size_t>(index)] = slot; });
+            }
+
+            if (worker->parked.load(std::memory_order_seq_cst))
+            {
+                // Como en AudioRenderThreadPool: despertar al trabajador toma
+                // el mutex de su evento, raro y acotado
+                const AudioThreadTrap::ScopedAllowance allowWakeUp;
+                worker->notify();
+            }
+
+            return slot;
+        }
+
+        // Sin ranuras libres el trabajador no avanza: el hilo de audio calcula
+        // lo encolado. Todo lo encolado tiene ya terminado su bloque anterior.
+        for (int slot = 0; slot < maxTailJobs; ++slot)
+            if (tryRunTailJob(slot))
+                numLateTailBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    engine.runTailJob(segment, chunk);
+    engine.outstandingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    numLateTailBlocks.fetch_add(1, std::memory_order_relaxed);
+    return -1;
+}
+
+void AudioConvolution::waitForTailJob(int slot, const std::atomic<juce::int64>& completedChunks, juce::int64 chunk) noexcept
+{
+    if (completedChunks.load(std::memory_order_acquire) > chunk)
+        return;
+
+    // El trabajador va tarde: si aún no lo ha empezado, lo calcula el hilo de audio
+    if (slot >= 0 && tryRunTailJob(slot))
+        numLateTailBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    // Ya lo está calculando: no queda más remedio que esperarlo
+    if (completedChunks.load(std::memory_order_acquire) <= chunk)
+    {
+        numTailWaits.fetch_add(1, std::memory_order_relaxed);
+
+        while (completedChunks.load(std::memory_order_acquire) <= chunk)
+            AudioSpinWait::pause();
+    }
+}
+
+bool AudioConvolution::tryRunTailJob(int slot) noexcept
+{
+    auto& job = tailJobs[static_cast<size_t>(slot)];
+    int expected = TailJob::kQueued;
+
+    if (!job.state.compare_exchange_strong(expected, TailJob::kRunning, std::memory_order_acq_rel))
+        return false;
+
+    auto* engine = job.engine;
+    engine->runTailJob(job.segment, job.chunk);
+
+    // Lo último que toca el motor: a partir de aquí se puede retirar
+    engine->outstandingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    job.state.store(TailJob::kFree, std::memory_order_release);
+    return true;
+}
@@ -1,14 +1,19 @@
 #include "AudioEngine.h"
+#include "AudioThreadTrap.h"
 
 AudioEngine::AudioEngine()
 {
-    // Inicialización del motor de audio
-    // Aquí puedes inicializar sintetizadores, efectos, etc.
+    // Los nodos del grafo reciben los cambios de parámetros de los widgets
+    graph.setParameterTable(&parameters);
+
+    // Sólo hace algo si se compiló con DAWMAKER_AUDIO_THREAD_TRAP
+    AudioThreadTrap::startReporting();
 }
 
 AudioEngine::~AudioEngine()
 {
     releaseResources();
+    AudioThreadTrap::stopReporting();
 }
 
 void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
@@ -17,37 +22,145 @@ void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
     currentSampleRate = sampleRate;
     currentBufferSize = samplesPerBlockExpected;
 
-    // Preparar procesadores de audio
-    // Ejemplo:
-    // synth.setCurrentPlaybackSampleRate(sampleRate);
-    
+    // El grafo trabaja siempre con el bloque interno, no con el del dispositivo
+    blockAdapter.prepare(numChannels, internalBlockSize, samplesPerBlockExpected);
+    processingBlockSize = blockAdapter.isActive() ? blockAdapter.getBlockSize() : samplesPerBlockExpected;
+
+    // Preparar el grafo: compila y publica una secuencia con los buffers y la
+    // memoria temporal dimensionados para el bloque máximo. Nada de lo que
+    // ocurre después en el callback reserva memoria.
+    graph.prepare(sampleRate, processingBlockSize, numChannels);
+    automation.prepare(processingBlockSize);
+
     juce::Logger::writeToLog(juce::String("AudioEngine prepared: ") +
                              juce::String(sampleRate) + " Hz, " +
-                             juce::String(samplesPerBlockExpected) + " samples");
+                             juce::String(samplesPerBlockExpected) + " samples (bloque interno " +
+                             juce::String(processingBlockSize) + ", latencia de adaptacion " +
+                             juce::String(blockAdapter.getLatencySamples()) + ")");
 }
 
 void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    // Por ahora, solo limpiamos el buffer (silencio)
-    // Aquí es donde procesarías audio real, sintetizarías sonidos, etc.
-    bufferToFill.clearActiveBufferRegion();
+    const AudioThreadTrap::ScopedAudioThread audioThreadScope;
 
-    // Ejemplo de cómo podrías procesar audio:
-    /*
-    auto* leftChannel = bufferToFill.buffer->getWritePointer(0, bufferToFill.startSample);
-    auto* rightChannel = bufferToFill.buffer->getWritePointer(1, bufferToFill.startSample);
-    
-    for (int sample = 0; sample < bufferToFill.numSamples; ++sample)
+    // Marcar la entrada antes de mirar el modo offline (seq_cst en ambos
+    // lados): así beginOfflineRender() sabe cuándo el grafo quedó libre
+    liveCallbackActive.store(true, std::memory_order_seq_cst);
+
+    if (offlineRendering.load(std::memory_order_seq_cst))
     {
-        // Generar o procesar audio aquí
-        leftChannel[sample] = 0.0f;
-        rightChannel[sample] = 0.0f;
+        bufferToFill.clearActiveBufferRegion();
+        liveCallbackActive.store(false, std::memory_order_release);
+        return;
     }
-    */
+
+    // Sin grafo conectado a la salida el resultado es silencio
+    blockAdapter.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                         [this](juce::AudioBuffer<float>& block, int startSample, int numSamples)
+                         {
+                             renderBlock(block, startSample, numSamples);
+                         });
+
+    liveCallbackActive.store(false, std::memory_order_release);
+}
+
+void AudioEngine::renderBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const auto seek = pendingSeek.exchange(-1, std::memory_order_acq_rel);
+
+    if (seek >= 0)
+    {
+        transportPosition = seek;
+        automation.resynchronise();
+    }
+
+    if (!playing.load(std::memory_order_acquire))
+    {
+        graph.process(buffer, startSample, numSamples);
+        return;
+    }
+
+    const int planBlockSize = juce::jmax(1, processingBlockSize);
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - offset, planBlockSize);
+        const auto& plan = automation.planBlock(transportPosition, chunk);
+
+        // Partir el bloque sólo en los saltos; las rampas viajan muestra a muestra
+        int event = 0;
+
+        for (int subStart = 0; subStart < chunk;)
+        {
+            // Los saltos entran por la tabla y el grafo los reparte al empezar el sub-bloque
+            for (; event < plan.numEvents && plan.events[event].sampleOffset <= subStart; ++event)
+                parameters.setValue(plan.events[event].parameterID, plan.events[event].value);
+
+            const int subEnd = event < plan.numEvents ? plan.events[event].sampleOffset : chunk;
+
+            for (int i = 0; i < plan.numRamps; ++i)
+                subBlockRamps[static_cast<size_t>(i)] = { plan.ramps[i].parameterID, plan.ramps[i].values + subStart };
+
+            graph.process(buffer, startSample + offset + subStart, subEnd - subStart,
+                          subBlockRamps.data(), plan.numRamps);
+            subStart = subEnd;
+        }
+
+        // Las rampas ya llegaron a los nodos: la tabla se queda con su último
+        // valor para que una secuencia nueva (y la GUI) no vuelva al de antes
+        for (int i = 0; i < plan.numRamps; ++i)
+            parameters.storeValue(plan.ramps[i].parameterID, plan.ramps[i].values[chunk - 1]);
+
+        transportPosition += chunk;
+        offset += chunk;
+    }
+
+    publishedPosition.store(transportPosition, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool AudioEngine::beginOfflineRender()
+{
+    if (currentSampleRate <= 0.0 || offlineRendering.exchange(true, std::memory_order_seq_cst))
+        return false;
+
+    // Esperar a que el callback en curso (si lo hay) salga del grafo
+    while (liveCallbackActive.load(std::memory_order_seq_cst))
+        juce::Thread::yield();
+
+    // El bounce empieza sin colas de lo que sonaba en vivo y con la
+    // automatización desde el principio
+    graph.resetNodes();
+
+    wasPlayingBeforeOffline = isPlaying();
+    positionBeforeOffline = getPlayPosition();
+    setPlayPosition(0);
+    setPlaying(true);
+    return true;
+}
+
+void AudioEngine::renderOfflineBlock(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    jassert(offlineRendering.load(std::memory_order_relaxed));
+
+    // Sin entrada de dispositivo en offline
+    buffer.clear(0, numSamples);
+    renderBlock(buffer, 0, numSamples);
+}
+
+void AudioEngine::endOfflineRender()
+{
+    graph.resetNodes();
+    blockAdapter.reset();
+
+    setPlaying(wasPlayingBeforeOffline);
+    setPlayPosition(positionBeforeOffline);
+    offlineRendering.store(false, std::memory_order_release);
 }
 
 void AudioEngine::releaseResources()
 {
     // Liberar recursos de audio
+    graph.releaseResources();
     juce::Logger::writeToLog("AudioEngine resources released");
 }
@@ -0,0 +1,842 @@
+#include "AudioGraph.h"
+
+//==============================================================================
+// RenderSequence - Grafo compilado, inmutable una vez publicado
+//==============================================================================
+struct AudioGraph::RenderSequence : public AudioRenderThreadPool::Job
+{
+    struct Step
+    {
+        AudioGraphNode* node = nullptr;
+        int firstInput = 0;  // índice en inputSources
+        int numInputs = 0;
+    };
+
+    // Una entrada: buffer de origen y, si llega antes que las demás, su retardo
+    struct Source
+    {
+        int bufferIndex = 0;
+        int delayIndex = -1;
+    };
+
+    // Línea de retardo circular de compensación para una conexión
+    struct CompensationDelay
+    {
+        juce::AudioBuffer<float> ring;
+        int position = 0;
+        int silentRun = 0; // muestras de silencio seguidas que han entrado
+
+        // Todo lo que queda dentro es silencio
+        bool isDrained() const noexcept { return silentRun >= ring.getNumSamples(); }
+
+        // Sale lo que entró hace ring.getNumSamples() muestras y entra src
+        void process(int channel, const float* src, float* dest, int numSamples, bool accumulate)
+        {
+            const int length = ring.getNumSamples();
+            auto* data = ring.getWritePointer(channel);
+            int pos = position;
+
+            while (numSamples > 0)
+            {
+                const int segment = juce::jmin(numSamples, length - pos);
+
+                if (accumulate)
+                    juce::FloatVectorOperations::add(dest, data + pos, segment);
+                else
+                    juce::FloatVectorOperations::copy(dest, data + pos, segment);
+
+                juce::FloatVectorOperations::copy(data + pos, src, segment);
+
+                pos = (pos + segment) % length;
+                src += segment;
+                dest += segment;
+                numSamples -= segment;
+            }
+        }
+
+        void advance(int numSamples, bool inputWasSilent)
+        {
+            position = (position + numSamples) % ring.getNumSamples();
+            silentRun = inputWasSilent ? juce::jmin(silentRun + numSamples, ring.getNumSamples()) : 0;
+        }
+    };
+
+    // Estado de reposo de cada paso (hilo de audio)
+    struct StepState
+    {
+        juce::int64 silentSamples = 0; // muestras seguidas procesadas con la entrada en silencio
+        bool sleeping = false;         // buffer ya a cero y nodo sin procesar
+    };
+
+    // Referencias que mantienen vivos los nodos mientras la secuencia exista,
+    // aunque se hayan eliminado del modelo
+    std::vector<std::shared_ptr<AudioGraphNode>> nodeRefs;
+
+    std::vector<Step> steps;            // orden topológico
+    std::vector<StepState> stepStates;
+    std::vector<Source> inputSources;   // buffer 0 = entrada del dispositivo
+    std::vector<Source> outputSources;  // lo que se suma a la salida
+
+    // Una línea por conexión compensada; cada una la usa un único paso
+    std::vector<CompensationDelay> compensationDelays;
+    int outputLatency = 0;
+
+    // Suscripciones (parámetro, nodo) ordenadas por ID para búsqueda binaria
+    std::vector<std::pair<ParameterTable::ParameterID, AudioGraphNode*>> parameterListeners;
+
+    // Buffer 0: copia de la entrada del dispositivo. Buffer i + 1: salida del paso i.
+    juce::AudioBuffer<float> buffers;
+
+    // Marca de silencio por buffer en el bloque actual. Cada paso sólo escribe
+    // la suya y sólo la leen los pasos que dependen de él.
+    std::vector<juce::uint8> bufferSilent;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+
+    // Planificación paralela; nula si el grafo es una sola cadena
+    std::unique_ptr<AudioRenderThreadPool::Schedule> schedule;
+    int currentNumSamples = 0;
+    std::unique_ptr<AudioScratchArena>* currentArenas = nullptr;
+
+    float* const* getChannels(int bufferIndex)
+    {
+        return buffers.getArrayOfWritePointers() + bufferIndex * numChannels;
+    }
+
+    void readSource(const Source& source, int channel, float* dest, int numSamples, bool accumulate)
+    {
+        const float* src = getChannels(source.bufferIndex)[channel];
+
+        if (source.delayIndex >= 0)
+            compensationDelays[static_cast<size_t>(source.delayIndex)].process(channel, src, dest, numSamples, accumulate);
+        else if (accumulate)
+            juce::FloatVectorOperations::add(dest, src, numSamples);
+        else
+            juce::FloatVectorOperations::copy(dest, src, numSamples);
+    }
+
+    void advanceDelays(const Source* sources, int numSources, int numSamples)
+    {
+        for (int i = 0; i < numSources; ++i)
+            if (sources[i].delayIndex >= 0)
+                compensationDelays[static_cast<size_t>(sources[i].delayIndex)]
+                    .advance(numSamples, bufferSilent[static_cast<size_t>(sources[i].bufferIndex)] != 0);
+    }
+
+    // Una entrada en silencio cuyo retardo (si lo tiene) ya sólo contiene
+    // ceros no aporta nada: ni se lee ni hace falta escribirla en el anillo
+    bool isSourceSilent(const Source& source) const noexcept
+    {
+        return bufferSilent[static_cast<size_t>(source.bufferIndex)] != 0
+                && (source.delayIndex < 0 || compensationDelays[static_cast<size_t>(source.delayIndex)].isDrained());
+    }
+
+    bool areSourcesSilent(const Source* sources, int numSources) const noexcept
+    {
+        for (int i = 0; i < numSources; ++i)
+            if (!isSourceSilent(sources[i]))
+                return false;
+
+        return true;
+    }
+
+    // Barrido de pico vectorizado
+    static bool isBelowSilenceThreshold(const float* const* channels, int numChannelsToScan, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannelsToScan; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch], numSamples);
+
+            if (juce::jmax(-range.getStart(), range.getEnd()) > AudioGraph::silenceThreshold)
+                return false;
+        }
+
+        return true;
+    }
+
+    void sumSources(const Source* sources, int numSources, float* const* dest, int numSamples)
+    {
+        bool anySummed = false;
+
+        for (int i = 0; i < numSources; ++i)
+        {
+            if (isSourceSilent(sources[i]))
+                continue;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                readSource(sources[i], ch, dest[ch], numSamples, anySummed);
+
+            anySummed = true;
+        }
+
+        if (!anySummed)
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::clear(dest[ch], numSamples);
+
+        advanceDelays(sources, numSources, numSamples);
+    }
+
+    // Cada paso escribe sólo en su propio buffer: los pasos independientes
+    // pueden ejecutarse en paralelo sin sincronización adicional
+    void runTask(int taskIndex, int workerIndex) override
+    {
+        const auto& step = steps[static_cast<size_t>(taskIndex)];
+        auto& state = stepStates[static_cast<size_t>(taskIndex)];
+        auto& outputSilent = bufferSilent[static_cast<size_t>(taskIndex + 1)];
+        auto* const* channels = getChannels(taskIndex + 1);
+        const auto* sources = inputSources.data() + step.firstInput;
+        auto* node = step.node;
+
+        // Un parámetro que cambia despierta al nodo en este mismo bloque
+        const bool wake = node->wakeRequested;
+        node->wakeRequested = false;
+
+        // Primero sólo con las marcas: las entradas dormidas no se tocan
+        bool inputSilent = areSourcesSilent(sources, step.numInputs);
+
+        if (inputSilent && !wake)
+        {
+            const int tail = node->getTailSamples();
+
+            // La cola se cuenta desde que la salida refleja la entrada
+            if (tail != AudioGraphNode::infiniteTail
+                && state.silentSamples >= static_cast<juce::int64>(tail) + node->getLatencySamples())
+            {
+                advanceDelays(sources, step.numInputs, currentNumSamples);
+
+                if (!state.sleeping)
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        juce::FloatVectorOperations::clear(channels[ch], currentNumSamples);
+
+                    state.sleeping = true;
+                }
+
+                outputSilent = 1;
+                return;
+            }
+        }
+
+        sumSources(sources, step.numInputs, channels, currentNumSamples);
+
+        if (!inputSilent)
+            inputSilent = isBelowSilenceThreshold(channels, numChannels, currentNumSamples);
+
+        state.silentSamples = (inputSilent && !wake) ? state.silentSamples + currentNumSamples : 0;
+        state.sleeping = false;
+        outputSilent = 0;
+
+        // Vista sobre memoria ya reservada: no reserva nada
+        juce::AudioBuffer<float> view(channels, numChannels, currentNumSamples);
+
+        auto& scratch = *currentArenas[workerIndex];
+        scratch.reset();
+        node->inputSilent = inputSilent;
+        node->process(view, scratch);
+    }
+
+    int countSleepingSteps() const noexcept
+    {
+        int count = 0;
+
+        for (const auto& state : stepStates)
+            count += state.sleeping ? 1 : 0;
+
+        return count;
+    }
+
+    void perform(juce::AudioBuffer<float>& deviceBuffer, int startSample, int numSamples,
+                 AudioRenderThreadPool& threadPool, std::unique_ptr<AudioScratchArena>* arenas)
+    {
+        const int deviceChannels = deviceBuffer.getNumChannels();
+
+        // Copiar la entrada antes de escribir: el dispositivo usa el mismo buffer
+        auto* const* inputChannels = getChannels(0);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (ch < deviceChannels)
+                juce::FloatVectorOperations::copy(inputChannels[ch], deviceBuffer.getReadPointer(ch, startSample), numSamples);
+            else
+                juce::FloatVectorOperations::clear(inputChannels[ch], numSamples);
+        }
+
+        bufferSilent[0] = isBelowSilenceThreshold(inputChannels, juce::jmin(numChannels, deviceChannels), numSamples) ? 1 : 0;
+
+        currentNumSamples = numSamples;
+        currentArenas = arenas;
+
+        if (schedule != nullptr && threadPool.isRunning())
+        {
+            threadPool.execute(*schedule, *this);
+        }
+        else
+        {
+            for (size_t i = 0; i < steps.size(); ++i)
+                runTask(static_cast<int>(i), 0);
+        }
+
+        for (int ch = 0; ch < deviceChannels; ++ch)
+        {
+            auto* dest = deviceBuffer.getWritePointer(ch, startSample);
+            bool anySummed = false;
+
+            if (ch < numChannels)
+            {
+                for (const auto& source : outputSources)
+                {
+                    if (isSourceSilent(source))
+                        continue;
+
+                    readSource(source, ch, dest, numSamples, anySummed);
+                    anySummed = true;
+                }
+            }
+
+            if (!anySummed)
+                juce::FloatVectorOperations::clear(dest, numSamples);
+        }
+
+        advanceDelays(outputSources.data(), static_cast<int>(outputSources.size()), numSamples);
+    }
+};
+
+//==============================================================================
+// MaintenanceThread - Libera las secuencias retiradas fuera del hilo de audio
+// y recompila la compensación cuando algún nodo cambia de latencia
+//==============================================================================
+class AudioGraph::MaintenanceThread : public juce::Thread
+{
+public:
+    explicit MaintenanceThread(AudioGraph& ownerGraph)
+        : juce::Thread("AudioGraph Maintenance"), graph(ownerGraph) {}
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            graph.reclaimRetiredSequences();
+            graph.rebuildIfLatencyChanged();
+            wait(50);
+        }
+    }
+
+private:
+    AudioGraph& graph;
+};
+
+//==============================================================================
+AudioGraph::AudioGraph()
+{
+    for (int i = 0; i <= threadPool.getNumWorkerThreads(); ++i)
+        scratchArenas.push_back(std::make_unique<AudioScratchArena>());
+
+    maintenanceThread = std::make_unique<MaintenanceThread>(*this);
+    maintenanceThread->startThread(juce::Thread::Priority::low);
+}
+
+AudioGraph::~AudioGraph()
+{
+    cancelPendingUpdate();
+
+    // El audio ya está detenido: liberar todo desde este hilo
+    threadPool.stop();
+    maintenanceThread->stopThread(1000);
+    reclaimRetiredSequences();
+
+    delete pendingSequence.exchange(nullptr);
+    delete activeSequence;
+    activeSequence = nullptr;
+}
+
+//==============================================================================
+AudioGraph::NodeID AudioGraph::addNode(std::unique_ptr<AudioGraphNode> newNode)
+{
+    if (newNode == nullptr)
+        return 0;
+
+    NodeID nodeID = 0;
+
+    {
+        const juce::ScopedLock sl(modelLock);
+
+        // Un nodo nuevo se prepara antes de que ninguna secuencia lo vea
+        if (isPrepared)
+            newNode->prepare(currentSampleRate, maximumBlockSize);
+
+        // Los cambios de latencia del nodo despiertan la recompilación
+        newNode->latencyChangedFlag.store(&latencyChanged, std::memory_order_release);
+
+        nodeID = nextNodeID++;
+        nodes[nodeID] = std::shared_ptr<AudioGraphNode>(newNode.release());
+    }
+
+    triggerAsyncUpdate();
+    return nodeID;
+}
+
+bool AudioGraph::removeNode(NodeID nodeID)
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+
+        if (nodes.erase(nodeID) == 0)
+            return false;
+
+        for (auto it = connections.begin(); it != connections.end();)
+        {
+            if (it->first == nodeID || it->second == nodeID)
+                it = connections.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    triggerAsyncUpdate();
+    return true;
+}
+
+bool AudioGraph::addConnection(NodeID source, NodeID destination)
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+
+        if (!canConnect(source, destination))
+            return false;
+
+        connections.insert({ source, destination });
+    }
+
+    triggerAsyncUpdate();
+    return true;
+}
+
+bool AudioGraph::removeConnection(NodeID source, NodeID destination)
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+
+        if (connections.erase({ source, destination }) == 0)
+            return false;
+    }
+
+    triggerAsyncUpdate();
+    return true;
+}
+
+bool AudioGraph::canConnect(NodeID source, NodeID destination) const
+{
+    const juce::ScopedLock sl(modelLock);
+
+    if (source == destination || source == audioOutputNodeID || destination == audioInputNodeID)
+        return false;
+
+    if (!isNodeOrEndpoint(source) || !isNodeOrEndpoint(destination))
+        return false;
+
+    if (connections.count({ source, destination }) != 0)
+        return false;
+
+    // Rechazar ciclos: el destino no puede ser ya un ancestro del origen
+    return !dependsOnLocked(source, destination);
+}
+
+AudioGraphNode* AudioGraph::getNodeForID(NodeID nodeID) const
+{
+    const juce::ScopedLock sl(modelLock);
+    auto it = nodes.find(nodeID);
+    return it != nodes.end() ? it->second.get() : nullptr;
+}
+
+int AudioGraph::getNumNodes() const
+{
+    const juce::ScopedLock sl(modelLock);
+    return static_cast<int>(nodes.size());
+}
+
+void AudioGraph::clear()
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+        nodes.clear();
+        connections.clear();
+    }
+
+    triggerAsyncUpdate();
+}
+
+bool AudioGraph::isNodeOrEndpoint(NodeID nodeID) const
+{
+    return nodeID == audioInputNodeID || nodeID == audioOutputNodeID || nodes.count(nodeID) != 0;
+}
+
+bool AudioGraph::dependsOnLocked(NodeID nodeID, NodeID possibleAncestor) const
+{
+    // Búsqueda hacia atrás desde nodeID siguiendo las conexiones de entrada
+    std::vector<NodeID> toVisit { nodeID };
+    std::set<NodeID> visited;
+
+    while (!toVisit.empty())
+    {
+        auto current = toVisit.back();
+        toVisit.pop_back();
+
+        if (current == possibleAncestor)
+            return true;
+
+        if (!visited.insert(current).second)
+            continue;
+
+        for (const auto& connection : connections)
+            if (connection.second == current)
+                toVisit.push_back(connection.first);
+    }
+
+    return false;
+}
+
+//==============================================================================
+void AudioGraph::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+
+        currentSampleRate = sampleRate;
+        maximumBlockSize = juce::jmax(1, maxBlockSize);
+        numGraphChannels = juce::jmax(1, numChannels);
+        isPrepared = true;
+
+        for (auto& entry : nodes)
+        {
+            entry.second->prepare(currentSampleRate, maximumBlockSize);
+            entry.second->reset();
+        }
+    }
+
+    // El callback está detenido: se puede redimensionar la memoria temporal
+    for (auto& arena : scratchArenas)
+        arena->prepare(scratchBuffersPerNode * numGraphChannels, maximumBlockSize);
+
+    threadPool.start(1000.0 * maximumBlockSize / juce::jmax(1.0, sampleRate));
+
+    rebuild();
+}
+
+void AudioGraph::resetNodes()
+{
+    const juce::ScopedLock sl(modelLock);
+
+    for (auto& entry : nodes)
+        entry.second->reset();
+}
+
+void AudioGraph::releaseResources()
+{
+    {
+        const juce::ScopedLock sl(modelLock);
+        isPrepared = false;
+    }
+
+    threadPool.stop();
+}
+
+//==============================================================================
+void AudioGraph::handleAsyncUpdate()
+{
+    rebuild();
+}
+
+bool AudioGraph::rebuild()
+{
+    // Se compila desde el hilo de mensajes y desde el de mantenimiento:
+    // publicar dentro del lock garantiza que gana siempre el modelo más reciente
+    const juce::ScopedLock sl(modelLock);
+
+    if (!isPrepared)
+        return false;
+
+    auto sequence = compileLocked();
+
+    if (sequence == nullptr)
+        return false;
+
+    publish(std::move(sequence));
+    return true;
+}
+
+void AudioGraph::rebuildIfLatencyChanged()
+{
+    if (latencyChanged.exchange(false, std::memory_order_acq_rel))
+        rebuild();
+}
+
+std::unique_ptr<AudioGraph::RenderSequence> AudioGraph::compileLocked() const
+{
+    // Entradas de cada nodo (sólo orígenes que son nodos o la entrada del dispositivo)
+    std::map<NodeID, std::vector<NodeID>> inputsOf;
+    std::map<NodeID, int> pendingInputs;
+    std::vector<NodeID> outputFeeds;
+
+    for (const auto& entry : nodes)
+        pendingInputs[entry.first] = 0;
+
+    for (const auto& connection : connections)
+    {
+        if (connection.second == audioOutputNodeID)
+        {
+            outputFeeds.push_back(connection.first);
+            continue;
+        }
+
+        inputsOf[connection.second].push_back(connection.first);
+
+        if (connection.first != audioInputNodeID)
+            ++pendingInputs[connection.second];
+    }
+
+    // Orden topológico (Kahn). Los IDs ordenados hacen la compilación determinista.
+    std::vector<NodeID> order;
+    std::vector<NodeID> ready;
+
+    for (const auto& entry : pendingInputs)
+        if (entry.second == 0)
+            ready.push_back(entry.first);
+
+    while (!ready.empty())
+    {
+        auto nodeID = ready.front();
+        ready.erase(ready.begin());
+        order.push_back(nodeID);
+
+        for (const auto& connection : connections)
+            if (connection.first == nodeID && connection.second != audioOutputNodeID)
+                if (--pendingInputs[connection.second] == 0)
+                    ready.push_back(connection.second);
+    }
+
+    if (order.size() != nodes.size())
+    {
+        juce::Logger::writeToLog("AudioGraph: ciclo detectado, se conserva la secuencia anterior");
+        return nullptr;
+    }
+
+    auto sequence = std::make_unique<RenderSequence>();
+    sequence->numChannels = numGraphChannels;
+    sequence->maxBlockSize = maximumBlockSize;
+
+    std::map<NodeID, int> bufferIndexOf { { audioInputNodeID, 0 } };
+
+    // Latencia acumulada a la salida de cada nodo (la entrada del dispositivo es 0)
+    std::map<NodeID, int> latencyOf { { audioInputNodeID, 0 } };
+
+    // Las entradas que llegan antes que la más lenta se retrasan la diferencia
+    auto addAlignedSources = [&](const std::vector<NodeID>& sources, std::vector<RenderSequence::Source>& dest) -> int
+    {
+        int alignedLatency = 0;
+
+        for (auto source : sources)
+            alignedLatency = juce::jmax(alignedLatency, latencyOf.at(source));
+
+        for (auto source : sources)
+        {
+            RenderSequence::Source entry;
+            entry.bufferIndex = bufferIndexOf.at(source);
+
+            if (const int delay = alignedLatency - latencyOf.at(source); delay > 0)
+            {
+                RenderSequence::CompensationDelay compensation;
+                compensation.ring.setSize(numGraphChannels, delay);
+                compensation.ring.clear();
+
+                entry.delayIndex = static_cast<int>(sequence->compensationDelays.size());
+                sequence->compensationDelays.push_back(std::move(compensation));
+            }
+
+            dest.push_back(entry);
+        }
+
+        return alignedLatency;
+    };
+
+    for (auto nodeID : order)
+    {
+        const auto& node = nodes.at(nodeID);
+
+        RenderSequence::Step step;
+        step.node = node.get();
+        step.firstInput = static_cast<int>(sequence->inputSources.size());
+
+        const int inputLatency = addAlignedSources(inputsOf[nodeID], sequence->inputSources);
+        latencyOf[nodeID] = inputLatency + node->getLatencySamples();
+
+        step.numInputs = static_cast<int>(sequence->inputSources.size()) - step.firstInput;
+
+        bufferIndexOf[nodeID] = static_cast<int>(sequence->steps.size()) + 1;
+        sequence->steps.push_back(step);
+        sequence->nodeRefs.push_back(node);
+    }
+
+    sequence->outputLatency = addAlignedSources(outputFeeds, sequence->outputSources);
+
+    for (const auto& step : sequence->steps)
+        for (auto parameterID : step.node->getParameterIDs())
+            sequence->parameterListeners.emplace_back(parameterID, step.node);
+
+    std::sort(sequence->parameterListeners.begin(), sequence->parameterListeners.end());
+
+    // Dependencias entre pasos (la entrada del dispositivo ya está copiada)
+    std::vector<std::vector<int>> dependencies(sequence->steps.size());
+    std::vector<int> levelOf(sequence->steps.size(), 0);
+    std::vector<int> levelWidths;
+
+    for (size_t i = 0; i < sequence->steps.size(); ++i)
+    {
+        const auto& step = sequence->steps[i];
+
+        for (int input = 0; input < step.numInputs; ++input)
+        {
+            const int source = sequence->inputSources[static_cast<size_t>(step.firstInput + input)].bufferIndex;
+
+            if (source > 0)
+            {
+                dependencies[i].push_back(source - 1);
+                levelOf[i] = juce::jmax(levelOf[i], levelOf[static_cast<size_t>(source - 1)] + 1);
+            }
+        }
+
+        if (static_cast<size_t>(levelOf[i]) >= levelWidths.size())
+            levelWidths.resize(static_cast<size_t>(levelOf[i]) + 1, 0);
+
+        ++levelWidths[static_cast<size_t>(levelOf[i])];
+    }
+
+    // Una sola cadena no gana nada repartiéndose: se queda en modo secuencial
+    const int maxParallelism = levelWidths.empty() ? 0 : *std::max_element(levelWidths.begin(), levelWidths.end());
+
+    if (maxParallelism > 1 && threadPool.getNumWorkerThreads() > 0)
+        sequence->schedule = threadPool.createSchedule(dependencies);
+
+    sequence->buffers.setSize(static_cast<int>(sequence->steps.size() + 1) * numGraphChannels,
+                              maximumBlockSize);
+    sequence->buffers.clear();
+    sequence->bufferSilent.assign(sequence->steps.size() + 1, 0);
+    sequence->stepStates.resize(sequence->steps.size());
+
+    return sequence;
+}
+
+void AudioGraph::publish(std::unique_ptr<RenderSequence> sequence)
+{
+    // Único intercambio atómico. Si el hilo de audio no llegó a recoger la
+    // secuencia pendiente anterior, nunca la vio y se puede liberar aquí.
+    std::unique_ptr<RenderSequence> neverUsed(pendingSequence.exchange(sequence.release(),
+                                                                        std::memory_order_acq_rel));
+}
+
+//==============================================================================
+void AudioGraph::retireActiveSequence()
+{
+    auto scope = retiredFifo.write(1);
+    scope.forEach([this](int index) { retiredSequences[static_cast<size_t>(index)] = activeSequence; });
+}
+
+void AudioGraph::reclaimRetiredSequences()
+{
+    auto scope = retiredFifo.read(retiredFifo.getNumReady());
+    scope.forEach([this](int index)
+    {
+        auto& slot = retiredSequences[static_cast<size_t>(index)];
+        delete slot;
+        slot = nullptr;
+    });
+}
+
+void AudioGraph::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                         const ParameterRamp* ramps, int numRamps)
+{
+    // Adoptar la secuencia publicada sólo si hay sitio para retirar la actual;
+    // si el hilo de fondo va con retraso se reintenta en el siguiente bloque
+    bool sequenceChanged = false;
+
+    if (retiredFifo.getFreeSpace() > 0)
+    {
+        if (auto* next = pendingSequence.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            if (activeSequence != nullptr)
+                retireActiveSequence();
+
+            activeSequence = next;
+            sequenceChanged = true;
+            outputLatencySamples.store(next->outputLatency, std::memory_order_relaxed);
+            sequenceNodes.store(static_cast<int>(next->steps.size()), std::memory_order_relaxed);
+        }
+    }
+
+    if (activeSequence == nullptr || activeSequence->maxBlockSize <= 0)
+    {
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    dispatchParameterChanges(sequenceChanged);
+
+    // El dispositivo puede entregar más muestras de las anunciadas
+    for (int offset = 0; offset < numSamples;)
+    {
+        const int chunk = juce::jmin(numSamples - offset, activeSequence->maxBlockSize);
+
+        if (numRamps > 0)
+            dispatchParameterRamps(ramps, numRamps, offset, chunk);
+
+        activeSequence->perform(buffer, startSample + offset, chunk, threadPool, scratchArenas.data());
+        offset += chunk;
+    }
+
+    sleepingNodes.store(activeSequence->countSleepingSteps(), std::memory_order_relaxed);
+}
+
+void AudioGraph::dispatchParameterRamps(const ParameterRamp* ramps, int numRamps, int offset, int numSamples)
+{
+    auto& listeners = activeSequence->parameterListeners;
+
+    for (int i = 0; i < numRamps; ++i)
+    {
+        const auto parameterID = ramps[i].parameterID;
+        auto it = std::lower_bound(listeners.begin(), listeners.end(), parameterID,
+                                   [](const auto& listener, ParameterTable::ParameterID id) { return listener.first < id; });
+
+        for (; it != listeners.end() && it->first == parameterID; ++it)
+        {
+            it->second->wakeRequested = true;
+            it->second->parameterRamp(parameterID, ramps[i].values + offset, numSamples);
+        }
+    }
+}
+
+void AudioGraph::dispatchParameterChanges(bool sequenceChanged)
+{
+    if (parameterTable == nullptr)
+        return;
+
+    auto& listeners = activeSequence->parameterListeners;
+
+    // Una secuencia recién adoptada puede traer nodos nuevos: sincronizarlos
+    // una vez con el valor actual de todo lo que leen
+    if (sequenceChanged)
+        for (const auto& listener : listeners)
+            listener.second->parameterChanged(listener.first, parameterTable->getValue(listener.first));
+
+    if (listeners.empty())
+        return;
+
+    parameterTable->forEachChangedParameter([&listeners](ParameterTable::ParameterID parameterID, float value)
+    {
+        auto it = std::lower_bound(listeners.begin(), listeners.end(), parameterID,
+                                   [](const auto& listener, ParameterTable::ParameterID id) { return listener.first < id; });
+
+        for (; it != listeners.end() && it->first == parameterID; ++it)
+        {
+            it->second->wakeRequested = true;
+            it->second->parameterChanged(parameterID, value);
+        }
+    });
+}
@@ -0,0 +1,269 @@
+#include "AudioOversampler.h"
+#include "AudioSimd.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Función de Bessel modificada de orden cero, para la ventana de Kaiser
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    // Fracción de la frecuencia base que se conserva sin atenuar (19.2 kHz a 48 kHz)
+    constexpr double passbandEdge = 0.4;
+}
+
+void AudioOversampler::prepare(int channels, int maxBlock, int factor, Quality newQuality)
+{
+    jassert(factor == 1 || factor == 2 || factor == 4 || factor == 8);
+
+    numChannels = juce::jmax(1, channels);
+    maxBlockSize = juce::jmax(1, maxBlock);
+    quality = newQuality;
+
+    const int numStages = factor >= 8 ? 3 : factor >= 4 ? 2 : factor >= 2 ? 1 : 0;
+    stages.clear();
+    stages.resize(static_cast<size_t>(numStages));
+
+    // Latencia acumulada en muestras de la frecuencia más alta
+    int topRateLatency = 0;
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[static_cast<size_t>(s)];
+
+        // Banda de paso relativa a la frecuencia de salida de la etapa: cada
+        // etapa que se añade deja más hueco libre y su filtro sale más corto
+        const double passband = passbandEdge / static_cast<double>(2 << s);
+        designStage(stage, 0.5 - 2.0 * passband, getStopbandAttenuationDb(quality));
+
+        const int inputSize = maxBlockSize << s;
+        const int halfLength = stage.halfLength;
+
+        stage.upHistory.setSize(numChannels, 2 * halfLength - 1 + inputSize);
+        stage.upFiltered.setSize(numChannels, inputSize);
+        stage.downEven.setSize(numChannels, 2 * halfLength - 1 + inputSize);
+        stage.downOdd.setSize(numChannels, halfLength + inputSize);
+        stage.output.setSize(numChannels, 2 * inputSize);
+
+        // Subida y bajada retrasan 2K - 1 muestras cada una a la frecuencia de la etapa
+        topRateLatency += (2 * halfLength - 1) << (numStages - s);
+    }
+
+    const int topFactor = 1 << numStages;
+    padSamples = (topFactor - topRateLatency % topFactor) % topFactor;
+    latencySamples = (topRateLatency + padSamples) / topFactor;
+    padHistory.setSize(numChannels, padSamples + (maxBlockSize << numStages));
+
+    reset();
+}
+
+void AudioOversampler::reset() noexcept
+{
+    for (auto& stage : stages)
+    {
+        stage.upHistory.clear();
+        stage.upFiltered.clear();
+        stage.downEven.clear();
+        stage.downOdd.clear();
+        stage.output.clear();
+    }
+
+    padHistory.clear();
+}
+
+int AudioOversampler::getMultipliesPerSample() const noexcept
+{
+    int multiplies = 0;
+
+    for (size_t s = 0; s < stages.size(); ++s)
+        multiplies += (2 * stages[s].halfLength + 1) << s;
+
+    return multiplies;
+}
+
+float AudioOversampler::getStopbandAttenuationDb(Quality q) noexcept
+{
+    switch (q)
+    {
+        case Quality::kDraft:    return 60.0f;
+        case Quality::kStandard: return 90.0f;
+        case Quality::kHigh:     return 120.0f;
+    }
+
+    return 90.0f;
+}
+
+void AudioOversampler::designStage(Stage& stage, double transitionWidth, double attenuationDb)
+{
+    // La estimación de Kaiser se queda corta con transiciones anchas (etapas
+    // de 4x y 8x), así que se parte de ella y se alarga hasta cumplir
+    const double estimatedLength = (attenuationDb - 7.95) / (14.36 * transitionWidth) + 1.0;
+    const double beta = attenuationDb > 50.0 ? 0.1102 * (attenuationDb - 8.7)
+                                             : 0.5842 * std::pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+    const double stopbandEdge = 0.25 + 0.5 * transitionWidth;
+    const double maxStopbandGain = std::pow(10.0, -attenuationDb / 20.0);
+
+    std::vector<double> evenBranch;
+
+    for (int halfLength = juce::jmax(2, static_cast<int>(std::ceil((estimatedLength + 1.0) / 4.0)));; ++halfLength)
+    {
+        // Rama par h[2m], m = 0 .. 2K - 1, con ventana de Kaiser; la impar es sólo el centro (0.5)
+        const int centre = 2 * halfLength - 1;
+        evenBranch.assign(static_cast<size_t>(2 * halfLength), 0.0);
+        double sum = 0.0;
+
+        for (int m = 0; m < 2 * halfLength; ++m)
+        {
+            const double offset = static_cast<double>(2 * m - centre);
+            const double sinc = std::sin(juce::MathConstants<double>::halfPi * offset) / (juce::MathConstants<double>::pi * offset);
+            const double r = offset / centre;
+            const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / besselI0(beta);
+
+            evenBranch[static_cast<size_t>(m)] = sinc * window;
+            sum += sinc * window;
+        }
+
+        // Ganancia en continua exacta: la rama par suma 0.5, igual que el centro
+        for (auto& tap : evenBranch)
+            tap *= 0.5 / sum;
+
+        // Respuesta de fase cero en la banda eliminada, hasta Nyquist de la etapa
+        double worstGain = 0.0;
+
+        for (int i = 0; i <= 512; ++i)
+        {
+            const double frequency = stopbandEdge + (0.5 - stopbandEdge) * i / 512.0;
+            double gain = 0.5;
+
+            for (int m = 0; m < halfLength; ++m)
+                gain += 2.0 * evenBranch[static_cast<size_t>(m)] * std::cos(juce::MathConstants<double>::twoPi * frequency * (centre - 2 * m));
+
+            worstGain = juce::jmax(worstGain, std::abs(gain));
+        }
+
+        if (worstGain <= maxStopbandGain || halfLength >= 64)
+        {
+            stage.halfLength = halfLength;
+            break;
+        }
+    }
+
+    stage.coefficients.resize(static_cast<size_t>(stage.halfLength));
+
+    for (int m = 0; m < stage.halfLength; ++m)
+        stage.coefficients[static_cast<size_t>(m)] = static_cast<float>(evenBranch[static_cast<size_t>(m)]);
+}
+
+void AudioOversampler::filterEvenBranch(const float* x, float* y, int numSamples, const float* coefficients, int halfLength) noexcept
+{
+    using AudioSimd::Vec;
+
+    const int last = 2 * halfLength - 1;
+
+    for (int j = 0; j < numSamples; j += Vec::width)
+    {
+        const int count = juce::jmin(Vec::width, numSamples - j);
+        Vec sum(0.0f);
+
+        // Pares simétricos: un producto por cada dos coeficientes
+        for (int m = 0; m < halfLength; ++m)
+            sum = sum + Vec(coefficients[m]) * (Vec::load(x + j - m, count) + Vec::load(x + j - last + m, count));
+
+        sum.store(y + j, count);
+    }
+}
+
+void AudioOversampler::upsampleChannel(int channel, const float* input, int numSamples) noexcept
+{
+    const float* source = input;
+    int num = numSamples;
+
+    for (auto& stage : stages)
+    {
+        const int halfLength = stage.halfLength;
+        const int past = 2 * halfLength - 1;
+
+        float* history = stage.upHistory.getWritePointer(channel);
+        float* filtered = stage.upFiltered.getWritePointer(channel);
+        float* output = stage.output.getWritePointer(channel);
+
+        std::memcpy(history + past, source, sizeof(float) * static_cast<size_t>(num));
+        filterEvenBranch(history + past, filtered, num, stage.coefficients.data(), halfLength);
+
+        // Ganancia 2 de la interpolación: la rama par se dobla y el centro (0.5) queda en 1
+        for (int j = 0; j < num; ++j)
+        {
+            output[2 * j] = 2.0f * filtered[j];
+            output[2 * j + 1] = history[halfLength + j];
+        }
+
+        std::memmove(history, history + num, sizeof(float) * static_cast<size_t>(past));
+
+        source = output;
+        num *= 2;
+    }
+}
+
+void AudioOversampler::downsampleChannel(int channel, float* output, int numSamples) noexcept
+{
+    using AudioSimd::Vec;
+
+    const int numStages = static_cast<int>(stages.size());
+
+    if (padSamples > 0)
+    {
+        const int topSamples = numSamples << numStages;
+        float* top = stages.back().output.getWritePointer(channel);
+        float* pad = padHistory.getWritePointer(channel);
+
+        std::memcpy(pad + padSamples, top, sizeof(float) * static_cast<size_t>(topSamples));
+        std::memcpy(top, pad, sizeof(float) * static_cast<size_t>(topSamples));
+        std::memmove(pad, pad + topSamples, sizeof(float) * static_cast<size_t>(padSamples));
+    }
+
+    for (int s = numStages - 1; s >= 0; --s)
+    {
+        auto& stage = stages[static_cast<size_t>(s)];
+        const int halfLength = stage.halfLength;
+        const int past = 2 * halfLength - 1;
+        const int num = numSamples << s;
+
+        const float* input = stage.output.getReadPointer(channel);
+        float* dest = s > 0 ? stages[static_cast<size_t>(s - 1)].output.getWritePointer(channel) : output;
+        float* even = stage.downEven.getWritePointer(channel);
+        float* odd = stage.downOdd.getWritePointer(channel);
+
+        for (int j = 0; j < num; ++j)
+        {
+            even[past + j] = input[2 * j];
+            odd[halfLength + j] = input[2 * j + 1];
+        }
+
+        filterEvenBranch(even + past, dest, num, stage.coefficients.data(), halfLength);
+
+        // Centro de la half-band: u[2j - (2K - 1)] es la impar j - K
+        for (int j = 0; j < num; j += Vec::width)
+        {
+            const int count = juce::jmin(Vec::width, num - j);
+            (Vec::load(dest + j, count) + Vec(0.5f) * Vec::load(odd + j, count)).store(dest + j, count);
+        }
+
+        std::memmove(even, even + num, sizeof(float) * static_cast<size_t>(past));
+        std::memmove(odd, odd + num, sizeof(float) * static_cast<size_t>(halfLength));
+    }
+}
@@ -0,0 +1,301 @@
+#include "AudioRenderThreadPool.h"
+#include "AudioSpinWait.h"
+#include "AudioThreadTrap.h"
+
+namespace
+{
+    // Iteraciones de espera activa antes de aparcar un trabajador ocioso
+    constexpr int spinIterationsBeforeParking = 4000;
+}
+
+//==============================================================================
+// WorkDeque
+//==============================================================================
+AudioRenderThreadPool::WorkDeque::WorkDeque(int capacity)
+{
+    const int size = juce::nextPowerOfTwo(juce::jmax(2, capacity));
+    tasks.reset(new std::atomic<int>[static_cast<size_t>(size)]);
+    mask = size - 1;
+}
+
+void AudioRenderThreadPool::WorkDeque::push(int task)
+{
+    // La capacidad cubre todas las tareas del grafo: nunca se llena
+    const auto b = bottom.load(std::memory_order_relaxed);
+    tasks[static_cast<size_t>(b & mask)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+bool AudioRenderThreadPool::WorkDeque::pop(int& task)
+{
+    const auto b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    task = tasks[static_cast<size_t>(b & mask)].load(std::memory_order_relaxed);
+
+    if (t != b)
+        return true;
+
+    // Último elemento: competir con los ladrones
+    const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+}
+
+bool AudioRenderThreadPool::WorkDeque::steal(int& task)
+{
+    auto t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+        return false;
+
+    task = tasks[static_cast<size_t>(t & mask)].load(std::memory_order_relaxed);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Worker - Hilo de tiempo real del pool
+//==============================================================================
+class AudioRenderThreadPool::Worker : public juce::Thread
+{
+public:
+    Worker(AudioRenderThreadPool& ownerPool, int index)
+        : juce::Thread("Audio Render Worker " + juce::String(index)),
+          pool(ownerPool), workerIndex(index) {}
+
+    void run() override
+    {
+        auto seenGeneration = pool.blockGeneration.load(std::memory_order_acquire);
+
+        while (!threadShouldExit())
+        {
+            int spins = 0;
+
+            while (pool.blockGeneration.load(std::memory_order_seq_cst) == seenGeneration)
+            {
+                if (threadShouldExit())
+                    return;
+
+                if (++spins < spinIterationsBeforeParking)
+                {
+                    AudioSpinWait::pause();
+                    continue;
+                }
+
+                // Aparcar: el hilo de audio comprueba 'parked' después de
+                // incrementar la generación, así que no se pierde el aviso
+                parked.store(true, std::memory_order_seq_cst);
+
+                if (pool.blockGeneration.load(std::memory_order_seq_cst) == seenGeneration)
+                    wait(10);
+
+                parked.store(false, std::memory_order_relaxed);
+                spins = 0;
+            }
+
+            seenGeneration = pool.blockGeneration.load(std::memory_order_acquire);
+            pool.participate(workerIndex);
+        }
+    }
+
+    std::atomic<bool> parked { false };
+
+private:
+    AudioRenderThreadPool& pool;
+    const int workerIndex;
+};
+
+//==============================================================================
+AudioRenderThreadPool::AudioRenderThreadPool(int numWorkerThreads)
+{
+    // El trabajador 0 es el propio hilo de audio
+    for (int i = 0; i < numWorkerThreads; ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i + 1));
+}
+
+AudioRenderThreadPool::~AudioRenderThreadPool()
+{
+    stop();
+}
+
+int AudioRenderThreadPool::getDefaultNumWorkerThreads()
+{
+    return juce::jlimit(0, 15, juce::SystemStats::getNumPhysicalCpus() - 1);
+}
+
+void AudioRenderThreadPool::start(double blockPeriodMs)
+{
+    if (running)
+        return;
+
+    const auto options = juce::Thread::RealtimeOptions{}.withPeriodMs(blockPeriodMs);
+
+    for (auto& worker : workers)
+        worker->startRealtimeThread(options);
+
+    running = !workers.empty();
+}
+
+void AudioRenderThreadPool::stop()
+{
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+
+    running = false;
+}
+
+//==============================================================================
+std::unique_ptr<AudioRenderThreadPool::Schedule>
+AudioRenderThreadPool::createSchedule(const std::vector<std::vector<int>>& dependencies) const
+{
+    auto schedule = std::make_unique<Schedule>();
+    const int numTasks = static_cast<int>(dependencies.size());
+
+    std::vector<std::vector<int>> successorsOf(dependencies.size());
+
+    for (int task = 0; task < numTasks; ++task)
+    {
+        for (auto dependency : dependencies[static_cast<size_t>(task)])
+            successorsOf[static_cast<size_t>(dependency)].push_back(task);
+
+        schedule->initialDependencies.push_back(static_cast<int>(dependencies[static_cast<size_t>(task)].size()));
+
+        if (dependencies[static_cast<size_t>(task)].empty())
+            schedule->rootTasks.push_back(task);
+    }
+
+    schedule->successorOffsets.push_back(0);
+
+    for (const auto& list : successorsOf)
+    {
+        schedule->successors.insert(schedule->successors.end(), list.begin(), list.end());
+        schedule->successorOffsets.push_back(static_cast<int>(schedule->successors.size()));
+    }
+
+    schedule->pendingDependencies.reset(new std::atomic<int>[static_cast<size_t>(juce::jmax(1, numTasks))]);
+
+    for (size_t i = 0; i <= workers.size(); ++i)
+        schedule->deques.push_back(std::make_unique<WorkDeque>(numTasks));
+
+    return schedule;
+}
+
+//==============================================================================
+void AudioRenderThreadPool::execute(Schedule& schedule, Job& job)
+{
+    const int numTasks = schedule.getNumTasks();
+
+    if (numTasks == 0)
+        return;
+
+    // Reiniciar contadores de dependencias para este bloque
+    for (int i = 0; i < numTasks; ++i)
+        schedule.pendingDependencies[static_cast<size_t>(i)].store(schedule.initialDependencies[static_cast<size_t>(i)],
+                                                                   std::memory_order_relaxed);
+
+    schedule.remainingTasks.store(numTasks, std::memory_order_relaxed);
+
+    for (auto task : schedule.rootTasks)
+        schedule.deques[0]->push(task);
+
+    currentJob = &job;
+    currentSchedule.store(&schedule, std::memory_order_seq_cst);
+    blockGeneration.fetch_add(1, std::memory_order_seq_cst);
+
+    {
+        // Despertar un trabajador aparcado toma el mutex de su evento: es
+        // raro y acotado, así que no se cuenta como infracción del callback
+        const AudioThreadTrap::ScopedAllowance allowWakeUp;
+
+        for (auto& worker : workers)
+            if (worker->parked.load(std::memory_order_seq_cst))
+                worker->notify();
+    }
+
+    workUntilDone(schedule, job, 0);
+
+    // Ningún trabajador puede seguir leyendo esta planificación al volver
+    currentSchedule.store(nullptr, std::memory_order_seq_cst);
+
+    while (activeWorkers.load(std::memory_order_seq_cst) > 0)
+        AudioSpinWait::pause();
+}
+
+void AudioRenderThreadPool::participate(int workerIndex)
+{
+    // Mientras ejecuta tareas del bloque, el trabajador cuenta como hilo de audio
+    const AudioThreadTrap::ScopedAudioThread audioThreadScope;
+
+    activeWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+    if (auto* schedule = currentSchedule.load(std::memory_order_seq_cst))
+        workUntilDone(*schedule, *currentJob, workerIndex);
+
+    activeWorkers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void AudioRenderThreadPool::workUntilDone(Schedule& schedule, Job& job, int workerIndex)
+{
+    auto& ownDeque = *schedule.deques[static_cast<size_t>(workerIndex)];
+
+    while (schedule.remainingTasks.load(std::memory_order_acquire) > 0)
+    {
+        int task = 0;
+
+        if (!ownDeque.pop(task) && !stealTask(schedule, workerIndex, task))
+        {
+            AudioSpinWait::pause();
+            continue;
+        }
+
+        job.runTask(task, workerIndex);
+
+        // Las tareas que quedan listas se empujan a la cola propia (localidad de caché)
+        const int first = schedule.successorOffsets[static_cast<size_t>(task)];
+        const int last = schedule.successorOffsets[static_cast<size_t>(task) + 1];
+
+        for (int i = first; i < last; ++i)
+        {
+            const int successor = schedule.successors[static_cast<size_t>(i)];
+
+            if (schedule.pendingDependencies[static_cast<size_t>(successor)].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ownDeque.push(successor);
+        }
+
+        schedule.remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool AudioRenderThreadPool::stealTask(Schedule& schedule, int thiefIndex, int& task)
+{
+    const int numDeques = static_cast<int>(schedule.deques.size());
+
+    for (int offset = 1; offset < numDeques; ++offset)
+    {
+        const int victim = (thiefIndex + offset) % numDeques;
+
+        if (schedule.deques[static_cast<size_t>(victim)]->steal(task))
+            return true;
+    }
+
+    return false;
+}
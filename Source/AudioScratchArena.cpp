@@ -0,0 +1,52 @@
+#include "AudioScratchArena.h"
+
+void AudioScratchArena::prepare(int numChannels, int maxBlockSize)
+{
+    capacityChannels = juce::jmax(0, numChannels);
+    capacitySamples = static_cast<size_t>(capacityChannels) * roundUpToAlignment(static_cast<size_t>(juce::jmax(0, maxBlockSize)));
+
+    // Margen para alinear el inicio a 64 bytes
+    storage.calloc(capacitySamples + alignmentInFloats);
+    alignedStorage = juce::snapPointerToAlignment(storage.get(), static_cast<size_t>(alignmentInFloats * sizeof(float)));
+
+    channelPointers.calloc(static_cast<size_t>(juce::jmax(1, capacityChannels)));
+
+    numOverflows.store(0, std::memory_order_relaxed);
+    reset();
+}
+
+void AudioScratchArena::release()
+{
+    storage.free();
+    channelPointers.free();
+    alignedStorage = nullptr;
+    capacitySamples = 0;
+    capacityChannels = 0;
+    reset();
+}
+
+juce::AudioBuffer<float> AudioScratchArena::allocate(int numChannels, int numSamples) noexcept
+{
+    const size_t stride = roundUpToAlignment(static_cast<size_t>(juce::jmax(0, numSamples)));
+    const size_t required = stride * static_cast<size_t>(juce::jmax(0, numChannels));
+
+    if (numChannels <= 0 || numSamples <= 0
+        || usedChannels + numChannels > capacityChannels
+        || usedSamples + required > capacitySamples)
+    {
+        if (numChannels > 0 && numSamples > 0)
+            numOverflows.fetch_add(1, std::memory_order_relaxed);
+
+        return juce::AudioBuffer<float>(channelPointers.get(), 0, 0);
+    }
+
+    float** channels = channelPointers.get() + usedChannels;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = alignedStorage + usedSamples + static_cast<size_t>(ch) * stride;
+
+    usedChannels += numChannels;
+    usedSamples += required;
+
+    return juce::AudioBuffer<float>(channels, numChannels, numSamples);
+}
@@ -0,0 +1,494 @@
+#include "AudioSpectralProcessor.h"
+#include "AudioSimd.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace
+{
+    juce::dsp::WindowingFunction<float>::WindowingMethod toWindowingMethod(AudioSpectralProcessor::Window window) noexcept
+    {
+        switch (window)
+        {
+            case AudioSpectralProcessor::Window::kHamming:          return juce::dsp::WindowingFunction<float>::hamming;
+            case AudioSpectralProcessor::Window::kBlackmanHarris:   return juce::dsp::WindowingFunction<float>::blackmanHarris;
+            case AudioSpectralProcessor::Window::kHann:
+            default:                                                return juce::dsp::WindowingFunction<float>::hann;
+        }
+    }
+
+    AudioSpectralProcessor::Settings sanitise(AudioSpectralProcessor::Settings settings) noexcept
+    {
+        settings.fftOrder = juce::jlimit(AudioSpectralProcessor::minFftOrder, AudioSpectralProcessor::maxFftOrder, settings.fftOrder);
+        settings.overlap = settings.overlap >= 8 ? 8 : (settings.overlap >= 4 ? 4 : 2);
+        return settings;
+    }
+}
+
+//==============================================================================
+// Plan: FFT y ventanas de una configuración; inmutable una vez creado
+//==============================================================================
+struct AudioSpectralProcessor::Plan
+{
+    explicit Plan(const Settings& settings)
+        : fft(settings.fftOrder),
+          size(1 << settings.fftOrder),
+          hop(size / settings.overlap)
+    {
+        // Ventana periódica: la simétrica de size + 1 puntos sin el último
+        std::vector<float> table(static_cast<size_t>(size + 1));
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(table.data(), table.size(),
+                                                                 toWindowingMethod(settings.window), false);
+        analysisWindow.assign(table.begin(), table.end() - 1);
+
+        // Síntesis = análisis / suma de los cuadrados que se solapan en cada
+        // posición: análisis por síntesis suma 1 en toda la salida
+        synthesisWindow.resize(static_cast<size_t>(size));
+
+        for (int n = 0; n < hop; ++n)
+        {
+            double sumOfSquares = 0.0;
+
+            for (int k = n; k < size; k += hop)
+                sumOfSquares += static_cast<double>(analysisWindow[static_cast<size_t>(k)]) * analysisWindow[static_cast<size_t>(k)];
+
+            const double scale = sumOfSquares > 0.0 ? 1.0 / sumOfSquares : 0.0;
+
+            for (int k = n; k < size; k += hop)
+                synthesisWindow[static_cast<size_t>(k)] = static_cast<float>(analysisWindow[static_cast<size_t>(k)] * scale);
+        }
+
+        double windowSum = 0.0;
+
+        for (auto w : analysisWindow)
+            windowSum += w;
+
+        fullScaleMagnitude = static_cast<float>(0.5 * windowSum);
+
+        // Una trama de fases aleatorias reparte su energía (la de la entrada
+        // enventanada) por igual en las size muestras; tras la síntesis y el
+        // solapamiento cada muestra recibe en media suma(s^2) / hop de ella
+        double analysisEnergy = 0.0;
+        double synthesisEnergy = 0.0;
+
+        for (int n = 0; n < size; ++n)
+        {
+            analysisEnergy += static_cast<double>(analysisWindow[static_cast<size_t>(n)]) * analysisWindow[static_cast<size_t>(n)];
+            synthesisEnergy += static_cast<double>(synthesisWindow[static_cast<size_t>(n)]) * synthesisWindow[static_cast<size_t>(n)];
+        }
+
+        incoherentGain = static_cast<float>(std::sqrt(static_cast<double>(size) * hop / (analysisEnergy * synthesisEnergy)));
+    }
+
+    juce::dsp::FFT fft;
+    const int size;
+    const int hop;
+    std::vector<float> analysisWindow;
+    std::vector<float> synthesisWindow;
+    float fullScaleMagnitude = 1.0f;
+    float incoherentGain = 1.0f;
+};
+
+std::shared_ptr<const AudioSpectralProcessor::Plan> AudioSpectralProcessor::getSharedPlan(const Settings& settings)
+{
+    // Sólo se guardan referencias débiles: un plan se libera con la última
+    // instancia que lo usa
+    static juce::CriticalSection lock;
+    static std::map<std::tuple<int, int, int>, std::weak_ptr<const Plan>> plans;
+
+    const juce::ScopedLock sl(lock);
+    auto& entry = plans[std::make_tuple(settings.fftOrder, settings.overlap, static_cast<int>(settings.window))];
+
+    if (auto existing = entry.lock())
+        return existing;
+
+    auto created = std::make_shared<const Plan>(settings);
+    entry = created;
+    return created;
+}
+
+//==============================================================================
+AudioSpectralProcessor::AudioSpectralProcessor() = default;
+AudioSpectralProcessor::~AudioSpectralProcessor() = default;
+
+void AudioSpectralProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    numChannels = juce::jmin(static_cast<int>(spec.numChannels), maxChannels);
+    prepared = true;
+    allocate();
+}
+
+void AudioSpectralProcessor::setSettings(const Settings& newSettings)
+{
+    settings = sanitise(newSettings);
+
+    if (prepared)
+        allocate();
+}
+
+void AudioSpectralProcessor::setFrameCallback(FrameCallback newCallback)
+{
+    callback = std::move(newCallback);
+}
+
+float AudioSpectralProcessor::getFullScaleMagnitude() const noexcept
+{
+    return plan != nullptr ? plan->fullScaleMagnitude : 1.0f;
+}
+
+float AudioSpectralProcessor::getIncoherentGain() const noexcept
+{
+    return plan != nullptr ? plan->incoherentGain : 1.0f;
+}
+
+void AudioSpectralProcessor::allocate()
+{
+    settings = sanitise(settings);
+    plan = getSharedPlan(settings);
+    fftSize = plan->size;
+    hopSize = plan->hop;
+    stride = AudioSimd::spectrumStride(fftSize / 2 + 1);
+
+    const auto channels = static_cast<size_t>(juce::jmax(1, numChannels));
+    inputFifos.assign(channels * static_cast<size_t>(fftSize), 0.0f);
+    outputAccumulators.assign(channels * static_cast<size_t>(fftSize), 0.0f);
+    spectra.assign(channels * static_cast<size_t>(2 * stride), 0.0f);
+    fftBuffer.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        realPointers[static_cast<size_t>(ch)] = spectra.data() + static_cast<size_t>(ch * 2 * stride);
+        imagPointers[static_cast<size_t>(ch)] = realPointers[static_cast<size_t>(ch)] + stride;
+    }
+
+    hopPosition = 0;
+}
+
+void AudioSpectralProcessor::reset()
+{
+    std::fill(inputFifos.begin(), inputFifos.end(), 0.0f);
+    std::fill(outputAccumulators.begin(), outputAccumulators.end(), 0.0f);
+    hopPosition = 0;
+}
+
+//==============================================================================
+void AudioSpectralProcessor::processSamples(const float* const* inputs, float* const* outputs, int channels, int numSamples) noexcept
+{
+    jassert(prepared);
+
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int count = juce::jmin(hopSize - hopPosition, numSamples - done);
+        const auto bytes = sizeof(float) * static_cast<size_t>(count);
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            std::memcpy(inputFifo(ch) + fftSize - hopSize + hopPosition, inputs[ch] + done, bytes);
+            std::memcpy(outputs[ch] + done, outputAccumulator(ch) + hopPosition, bytes);
+        }
+
+        hopPosition += count;
+        done += count;
+
+        if (hopPosition == hopSize)
+        {
+            processFrame(channels);
+            hopPosition = 0;
+        }
+    }
+}
+
+void AudioSpectralProcessor::processFrame(int channels) noexcept
+{
+    auto* buffer = fftBuffer.data();
+    const int numBins = fftSize / 2 + 1;
+    const auto keptBytes = sizeof(float) * static_cast<size_t>(fftSize - hopSize);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        auto* fifo = inputFifo(ch);
+        juce::FloatVectorOperations::multiply(buffer, fifo, plan->analysisWindow.data(), fftSize);
+        std::memmove(fifo, fifo + hopSize, keptBytes);
+
+        plan->fft.performRealOnlyForwardTransform(buffer, true);
+
+        auto* real = realPointers[static_cast<size_t>(ch)];
+        auto* imag = imagPointers[static_cast<size_t>(ch)];
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            real[bin] = buffer[2 * bin];
+            imag[bin] = buffer[2 * bin + 1];
+        }
+    }
+
+    if (callback)
+        callback({ realPointers.data(), imagPointers.data(), channels, numBins, stride, fftSize, hopSize, sampleRate });
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const auto* real = realPointers[static_cast<size_t>(ch)];
+        const auto* imag = imagPointers[static_cast<size_t>(ch)];
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            buffer[2 * bin] = real[bin];
+            buffer[2 * bin + 1] = imag[bin];
+        }
+
+        plan->fft.performRealOnlyInverseTransform(buffer);
+
+        // La suma en curso avanza un salto y recibe la trama entera
+        auto* accumulator = outputAccumulator(ch);
+        std::memmove(accumulator, accumulator + hopSize, keptBytes);
+        juce::FloatVectorOperations::clear(accumulator + fftSize - hopSize, hopSize);
+        juce::FloatVectorOperations::addWithMultiply(accumulator, buffer, plan->synthesisWindow.data(), fftSize);
+    }
+}
+
+//==============================================================================
+// AudioSpectralGate
+//==============================================================================
+void AudioSpectralGate::prepare(const AudioSpectralProcessor& processor)
+{
+    frameRate = processor.getSampleRate() / processor.getHopSize();
+    stride = processor.getStride();
+    const auto fullScale = processor.getFullScaleMagnitude();
+    fullScalePower = fullScale * fullScale;
+    gains.assign(static_cast<size_t>(processor.getNumChannels() * stride), 1.0f);
+    updateCoefficients();
+}
+
+void AudioSpectralGate::reset()
+{
+    std::fill(gains.begin(), gains.end(), 1.0f);
+}
+
+void AudioSpectralGate::setThreshold(float newThresholdDb)
+{
+    thresholdDb = juce::jlimit(-120.0f, 0.0f, newThresholdDb);
+    updateCoefficients();
+}
+
+void AudioSpectralGate::setRange(float newRangeDb)
+{
+    rangeDb = juce::jlimit(-120.0f, 0.0f, newRangeDb);
+    updateCoefficients();
+}
+
+void AudioSpectralGate::setRelease(float newReleaseMs)
+{
+    releaseMs = juce::jlimit(1.0f, 5000.0f, newReleaseMs);
+    updateCoefficients();
+}
+
+void AudioSpectralGate::updateCoefficients() noexcept
+{
+    thresholdPower = fullScalePower * juce::Decibels::decibelsToGain(thresholdDb * 2.0f, -240.0f);
+    closedGain = juce::Decibels::decibelsToGain(rangeDb, -120.0f);
+    releaseCoefficient = static_cast<float>(std::exp(-1.0 / (releaseMs * 0.001 * frameRate)));
+}
+
+void AudioSpectralGate::process(const AudioSpectralProcessor::Frame& frame) noexcept
+{
+    using AudioSimd::Vec;
+
+    jassert(frame.stride == stride);
+
+    const auto threshold = Vec(thresholdPower);
+    const auto closed = Vec(closedGain);
+    const auto open = Vec(1.0f);
+    const auto release = Vec(releaseCoefficient);
+
+    for (int ch = 0; ch < frame.numChannels; ++ch)
+    {
+        auto* real = frame.real[ch];
+        auto* imag = frame.imag[ch];
+        auto* gain = gains.data() + static_cast<size_t>(ch * stride);
+
+        for (int bin = 0; bin < frame.stride; bin += Vec::width)
+        {
+            const auto power = AudioSimd::magnitudeSquared(Vec::load(real + bin), Vec::load(imag + bin));
+            const auto target = AudioSimd::select(power < threshold, closed, open);
+            const auto previous = Vec::load(gain + bin);
+
+            // Abre al instante, cierra con la liberación
+            AudioSimd::select(target > previous, target, target + release * (previous - target)).store(gain + bin);
+        }
+
+        AudioSimd::scaleSpectrum(real, imag, gain, frame.stride);
+    }
+}
+
+//==============================================================================
+// AudioSpectralDenoiser
+//==============================================================================
+void AudioSpectralDenoiser::prepare(const AudioSpectralProcessor& processor)
+{
+    stride = processor.getStride();
+    const auto size = static_cast<size_t>(processor.getNumChannels() * stride);
+    noiseProfile.assign(size, 0.0f);
+    gains.assign(size, 1.0f);
+    numLearnedFrames = 0;
+
+    // Suavizado de las ganancias entre tramas, unos 50 ms
+    const double frameRate = processor.getSampleRate() / processor.getHopSize();
+    smoothing = static_cast<float>(std::exp(-1.0 / (0.05 * frameRate)));
+}
+
+void AudioSpectralDenoiser::reset()
+{
+    std::fill(gains.begin(), gains.end(), 1.0f);
+}
+
+void AudioSpectralDenoiser::setLearning(bool shouldLearn)
+{
+    if (shouldLearn && !learning)
+        restartProfile = true;
+
+    learning = shouldLearn;
+}
+
+void AudioSpectralDenoiser::setSensitivity(float newSensitivity)
+{
+    sensitivity = juce::jlimit(1.0f, 4.0f, newSensitivity);
+}
+
+void AudioSpectralDenoiser::setReduction(float newReductionDb)
+{
+    floorGain = juce::Decibels::decibelsToGain(-juce::jlimit(0.0f, 60.0f, newReductionDb));
+}
+
+void AudioSpectralDenoiser::process(const AudioSpectralProcessor::Frame& frame) noexcept
+{
+    using AudioSimd::Vec;
+
+    jassert(frame.stride == stride);
+
+    if (learning)
+    {
+        if (restartProfile)
+        {
+            restartProfile = false;
+            numLearnedFrames = 0;
+        }
+
+        // Media acumulada de la potencia: 1 / n con la trama n-ésima
+        const auto weight = Vec(1.0f / static_cast<float>(++numLearnedFrames));
+
+        for (int ch = 0; ch < frame.numChannels; ++ch)
+        {
+            auto* profile = noiseProfile.data() + static_cast<size_t>(ch * stride);
+
+            for (int bin = 0; bin < frame.stride; bin += Vec::width)
+            {
+                const auto power = AudioSimd::magnitudeSquared(Vec::load(frame.real[ch] + bin), Vec::load(frame.imag[ch] + bin));
+                const auto mean = Vec::load(profile + bin);
+                (mean + (power - mean) * weight).store(profile + bin);
+            }
+        }
+
+        return;
+    }
+
+    if (numLearnedFrames == 0)
+        return;
+
+    const auto floor = Vec(floorGain);
+    const auto scale = Vec(sensitivity);
+    const auto coefficient = Vec(smoothing);
+    const auto tiny = Vec(1.0e-20f);
+
+    for (int ch = 0; ch < frame.numChannels; ++ch)
+    {
+        auto* real = frame.real[ch];
+        auto* imag = frame.imag[ch];
+        const auto* profile = noiseProfile.data() + static_cast<size_t>(ch * stride);
+        auto* gain = gains.data() + static_cast<size_t>(ch * stride);
+
+        for (int bin = 0; bin < frame.stride; bin += Vec::width)
+        {
+            const auto power = AudioSimd::magnitudeSquared(Vec::load(real + bin), Vec::load(imag + bin));
+            const auto target = AudioSimd::max(floor, 1.0f - scale * Vec::load(profile + bin) / (power + tiny));
+            const auto previous = Vec::load(gain + bin);
+            (target + coefficient * (previous - target)).store(gain + bin);
+        }
+
+        AudioSimd::scaleSpectrum(real, imag, gain, frame.stride);
+    }
+}
+
+//==============================================================================
+// AudioSpectralFreeze
+//==============================================================================
+void AudioSpectralFreeze::prepare(const AudioSpectralProcessor& processor)
+{
+    stride = processor.getStride();
+    gain = processor.getIncoherentGain();
+    magnitudes.assign(static_cast<size_t>(processor.getNumChannels() * stride), 0.0f);
+    captured = false;
+
+    for (int i = 0; i < numPhasors; ++i)
+    {
+        const auto angle = juce::MathConstants<double>::twoPi * i / numPhasors;
+        phasorReal[static_cast<size_t>(i)] = static_cast<float>(std::cos(angle));
+        phasorImag[static_cast<size_t>(i)] = static_cast<float>(std::sin(angle));
+    }
+}
+
+void AudioSpectralFreeze::reset()
+{
+    captured = false;
+}
+
+void AudioSpectralFreeze::setFrozen(bool shouldFreeze)
+{
+    frozen = shouldFreeze;
+}
+
+void AudioSpectralFreeze::process(const AudioSpectralProcessor::Frame& frame) noexcept
+{
+    jassert(frame.stride == stride);
+
+    if (!frozen)
+    {
+        captured = false;
+        return;
+    }
+
+    if (!captured)
+    {
+        captured = true;
+
+        for (int ch = 0; ch < frame.numChannels; ++ch)
+        {
+            auto* magnitude = magnitudes.data() + static_cast<size_t>(ch * stride);
+
+            for (int bin = 0; bin < frame.numBins; ++bin)
+                magnitude[bin] = gain * std::sqrt(frame.real[ch][bin] * frame.real[ch][bin] + frame.imag[ch][bin] * frame.imag[ch][bin]);
+        }
+    }
+
+    // La misma fase en todos los canales: la imagen estéreo se conserva
+    for (int bin = 0; bin < frame.numBins; ++bin)
+    {
+        randomState = randomState * 1664525u + 1013904223u;
+        const auto phasor = static_cast<size_t>(randomState >> 26);
+
+        // Continua y Nyquist son reales
+        const bool realOnly = bin == 0 || bin == frame.numBins - 1;
+        const auto re = realOnly ? 1.0f : phasorReal[phasor];
+        const auto im = realOnly ? 0.0f : phasorImag[phasor];
+
+        for (int ch = 0; ch < frame.numChannels; ++ch)
+        {
+            const auto magnitude = magnitudes[static_cast<size_t>(ch * stride + bin)];
+            frame.real[ch][bin] = magnitude * re;
+            frame.imag[ch][bin] = magnitude * im;
+        }
+    }
+}
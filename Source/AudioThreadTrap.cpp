@@ -0,0 +1,319 @@
+#include "AudioThreadTrap.h"
+
+#if DAWMAKER_AUDIO_THREAD_TRAP
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+#endif
+
+namespace
+{
+    constexpr int maxFrames = 24;
+    constexpr int ringSize = 256;
+
+    struct ViolationRecord
+    {
+        // Vyukov: vale pos cuando el hueco está libre para la escritura pos y
+        // pos + 1 cuando ya tiene su registro; el lector lo libera con pos + ringSize
+        std::atomic<juce::uint32> sequence { 0 };
+        AudioThreadTrap::Violation violation = AudioThreadTrap::Violation::allocation;
+        size_t numBytes = 0;
+        int numFrames = 0;
+        std::array<void*, maxFrames> frames {};
+    };
+
+    // Estado por hilo: tipos triviales para que el acceso no reserve memoria
+    thread_local int audioThreadDepth = 0;
+    thread_local int suppressDepth = 0;
+
+    struct Ring
+    {
+        Ring() noexcept
+        {
+            for (juce::uint32 i = 0; i < ringSize; ++i)
+                records[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        std::array<ViolationRecord, ringSize> records;
+    };
+
+    Ring ring;
+    std::atomic<juce::uint32> writeIndex { 0 };
+    std::atomic<juce::uint32> numDropped { 0 };
+    juce::uint32 readIndex = 0; // sólo el hilo de informe
+
+    int captureStack(void** frames, int capacity) noexcept
+    {
+       #if JUCE_WINDOWS
+        return static_cast<int>(RtlCaptureStackBackTrace(0, static_cast<DWORD>(capacity), frames, nullptr));
+       #else
+        return backtrace(frames, capacity);
+       #endif
+    }
+
+    juce::String describeViolation(const ViolationRecord& record)
+    {
+        switch (record.violation)
+        {
+            case AudioThreadTrap::Violation::allocation:
+                return "reserva de " + juce::String(static_cast<juce::int64>(record.numBytes)) + " bytes";
+            case AudioThreadTrap::Violation::deallocation:
+                return "liberacion de memoria";
+            case AudioThreadTrap::Violation::lock:
+                return "lock de mutex";
+        }
+
+        return {};
+    }
+
+    juce::String describeStack(const ViolationRecord& record)
+    {
+        juce::String text;
+
+       #if JUCE_WINDOWS
+        for (int i = 0; i < record.numFrames; ++i)
+            text << "    #" << juce::String(i) << " 0x" << juce::String::toHexString(reinterpret_cast<juce::pointer_sized_int>(record.frames[static_cast<size_t>(i)])) << juce::newLine;
+       #else
+        // backtrace_symbols reserva memoria: aquí ya no importa, es el hilo de informe
+        if (char** symbols = backtrace_symbols(record.frames.data(), record.numFrames))
+        {
+            for (int i = 0; i < record.numFrames; ++i)
+                text << "    #" << juce::String(i) << " " << symbols[i] << juce::newLine;
+
+            std::free(symbols);
+        }
+       #endif
+
+        return text;
+    }
+
+    //==========================================================================
+    class ReportThread : public juce::Thread
+    {
+    public:
+        ReportThread() : juce::Thread("Audio Thread Trap") {}
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                drain();
+                wait(100);
+            }
+
+            drain();
+        }
+
+    private:
+        void drain()
+        {
+            for (;;)
+            {
+                auto& record = ring.records[readIndex % ringSize];
+
+                if (record.sequence.load(std::memory_order_acquire) != readIndex + 1)
+                    break;
+
+                juce::Logger::writeToLog("AudioThreadTrap: " + describeViolation(record)
+                                         + " en el hilo de audio" + juce::newLine + describeStack(record));
+
+                record.sequence.store(readIndex + ringSize, std::memory_order_release);
+                ++readIndex;
+            }
+
+            if (auto dropped = numDropped.exchange(0, std::memory_order_relaxed))
+                juce::Logger::writeToLog("AudioThreadTrap: " + juce::String(static_cast<int>(dropped))
+                                         + " infracciones descartadas (anillo lleno)");
+        }
+    };
+
+    std::unique_ptr<ReportThread> reportThread;
+}
+
+//==============================================================================
+AudioThreadTrap::ScopedAudioThread::ScopedAudioThread() noexcept   { ++audioThreadDepth; }
+AudioThreadTrap::ScopedAudioThread::~ScopedAudioThread() noexcept  { --audioThreadDepth; }
+AudioThreadTrap::ScopedAllowance::ScopedAllowance() noexcept       { ++suppressDepth; }
+AudioThreadTrap::ScopedAllowance::~ScopedAllowance() noexcept      { --suppressDepth; }
+
+bool AudioThreadTrap::isTrappingCurrentThread() noexcept
+{
+    return audioThreadDepth > 0 && suppressDepth == 0;
+}
+
+void AudioThreadTrap::recordViolation(Violation violation, size_t numBytes) noexcept
+{
+    // Lo que haga la captura de la pila no debe volver a entrar aquí
+    ++suppressDepth;
+
+    // Cada escritor reserva su hueco con un CAS sobre el índice; con el anillo
+    // lleno se descarta sin avanzarlo
+    auto position = writeIndex.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& record = ring.records[position % ringSize];
+        const auto sequence = record.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<juce::int32>(sequence - position);
+
+        if (difference == 0)
+        {
+            if (writeIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                record.violation = violation;
+                record.numBytes = numBytes;
+                record.numFrames = captureStack(record.frames.data(), maxFrames);
+                record.sequence.store(position + 1, std::memory_order_release);
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        else
+        {
+            position = writeIndex.load(std::memory_order_relaxed);
+        }
+    }
+
+    --suppressDepth;
+}
+
+void AudioThreadTrap::startReporting()
+{
+    if (reportThread != nullptr)
+        return;
+
+    // La primera captura de pila puede cargar el unwinder y reservar memoria:
+    // hacerla aquí para que no aparezca como infracción del hilo de audio
+    void* warmUp[maxFrames];
+    juce::ignoreUnused(captureStack(warmUp, maxFrames));
+
+    reportThread = std::make_unique<ReportThread>();
+    reportThread->startThread(juce::Thread::Priority::low);
+
+    juce::Logger::writeToLog("AudioThreadTrap: vigilando reservas y locks en el hilo de audio");
+}
+
+void AudioThreadTrap::stopReporting()
+{
+    if (reportThread == nullptr)
+        return;
+
+    reportThread->stopThread(1000);
+    reportThread.reset();
+}
+
+//==============================================================================
+// Interceptores
+//==============================================================================
+#if defined(__GLIBC__)
+
+// glibc: sustituir los símbolos y delegar en sus implementaciones internas.
+// Cubre también las reservas de librerías C y los locks de juce::CriticalSection.
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void  __libc_free(void*);
+
+    void* malloc(size_t size) noexcept
+    {
+        if (AudioThreadTrap::isTrappingCurrentThread())
+            AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::allocation, size);
+
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        if (AudioThreadTrap::isTrappingCurrentThread())
+            AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::allocation, count * size);
+
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        if (AudioThreadTrap::isTrappingCurrentThread())
+            AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::allocation, size);
+
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr && AudioThreadTrap::isTrappingCurrentThread())
+            AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::deallocation, 0);
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        if (AudioThreadTrap::isTrappingCurrentThread())
+            AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::lock, 0);
+
+        // La versión real se resuelve la primera vez; dlsym no usa este símbolo
+        using LockFunction = int (*)(pthread_mutex_t*);
+        static std::atomic<LockFunction> realLock { nullptr };
+
+        auto lock = realLock.load(std::memory_order_acquire);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store(lock, std::memory_order_release);
+        }
+
+        return lock(mutex);
+    }
+}
+
+#else
+
+// Resto de plataformas: sólo las reservas de C++ (operator new/delete)
+void* operator new(size_t size)
+{
+    if (AudioThreadTrap::isTrappingCurrentThread())
+        AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::allocation, size);
+
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)                                   { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept     { try { return operator new(size); } catch (...) { return nullptr; } }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept   { return operator new(size, std::nothrow); }
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr && AudioThreadTrap::isTrappingCurrentThread())
+        AudioThreadTrap::recordViolation(AudioThreadTrap::Violation::deallocation, 0);
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept                          { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept                    { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept                  { operator delete(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept     { operator delete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept   { operator delete(pointer); }
+
+#endif
+
+#endif // DAWMAKER_AUDIO_THREAD_TRAP
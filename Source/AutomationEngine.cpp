@@ -0,0 +1,298 @@
+#include "AutomationEngine.h"
+#include <algorithm>
+#include <limits>
+
+//==============================================================================
+// Snapshot - Copia inmutable de las líneas que lee el hilo de audio
+//==============================================================================
+struct AutomationEngine::Snapshot
+{
+    struct Lane
+    {
+        ParameterTable::ParameterID parameterID = ParameterTable::invalidParameterID;
+        std::vector<Breakpoint> points;
+
+        // Estado del hilo de audio: último valor entregado a los nodos
+        float lastSentValue = 0.0f;
+        bool hasSentValue = false;
+
+        // Índice del último punto con posición <= t, o -1 si t es anterior al primero
+        int segmentAt(juce::int64 t) const noexcept
+        {
+            auto it = std::upper_bound(points.begin(), points.end(), t,
+                                       [](juce::int64 position, const Breakpoint& point) { return position < point.samplePosition; });
+            return static_cast<int>(it - points.begin()) - 1;
+        }
+
+        juce::int64 segmentEnd(int segment) const noexcept
+        {
+            return segment + 1 < static_cast<int>(points.size()) ? points[static_cast<size_t>(segment + 1)].samplePosition
+                                                                 : std::numeric_limits<juce::int64>::max();
+        }
+
+        bool isRamp(int segment) const noexcept
+        {
+            if (segment < 0 || segment + 1 >= static_cast<int>(points.size()))
+                return false;
+
+            const auto& from = points[static_cast<size_t>(segment)];
+            const auto& to = points[static_cast<size_t>(segment + 1)];
+            return from.curve == Curve::linear && from.value != to.value && to.samplePosition > from.samplePosition;
+        }
+
+        float valueAt(int segment, juce::int64 t) const noexcept
+        {
+            if (segment < 0)
+                return points.front().value;
+
+            const auto& from = points[static_cast<size_t>(segment)];
+
+            if (!isRamp(segment))
+                return from.value;
+
+            const auto& to = points[static_cast<size_t>(segment + 1)];
+            const double proportion = static_cast<double>(t - from.samplePosition)
+                                        / static_cast<double>(to.samplePosition - from.samplePosition);
+            return from.value + static_cast<float>(proportion) * (to.value - from.value);
+        }
+    };
+
+    std::vector<Lane> lanes;
+};
+
+//==============================================================================
+AutomationEngine::AutomationEngine()
+{
+    startTimer(200);
+}
+
+AutomationEngine::~AutomationEngine()
+{
+    stopTimer();
+
+    // El audio ya está detenido
+    reclaimRetiredSnapshots();
+    delete pendingSnapshot.exchange(nullptr);
+    delete activeSnapshot;
+    activeSnapshot = nullptr;
+}
+
+//==============================================================================
+void AutomationEngine::setLane(ParameterTable::ParameterID parameterID, std::vector<Breakpoint> points)
+{
+    if (parameterID == ParameterTable::invalidParameterID)
+        return;
+
+    std::stable_sort(points.begin(), points.end(),
+                     [](const Breakpoint& a, const Breakpoint& b) { return a.samplePosition < b.samplePosition; });
+
+    const juce::ScopedLock sl(laneLock);
+
+    if (points.empty())
+        lanes.erase(parameterID);
+    else
+        lanes[parameterID] = std::move(points);
+
+    publishLocked();
+}
+
+void AutomationEngine::removeLane(ParameterTable::ParameterID parameterID)
+{
+    const juce::ScopedLock sl(laneLock);
+
+    if (lanes.erase(parameterID) != 0)
+        publishLocked();
+}
+
+void AutomationEngine::clear()
+{
+    const juce::ScopedLock sl(laneLock);
+    lanes.clear();
+    publishLocked();
+}
+
+std::vector<AutomationEngine::Breakpoint> AutomationEngine::getLane(ParameterTable::ParameterID parameterID) const
+{
+    const juce::ScopedLock sl(laneLock);
+    auto it = lanes.find(parameterID);
+    return it != lanes.end() ? it->second : std::vector<Breakpoint>();
+}
+
+int AutomationEngine::getNumLanes() const
+{
+    const juce::ScopedLock sl(laneLock);
+    return static_cast<int>(lanes.size());
+}
+
+void AutomationEngine::prepare(int maximumBlockSize)
+{
+    rampScratch.prepare(maxRampsPerBlock, maximumBlockSize);
+    resyncRequested = true;
+}
+
+//==============================================================================
+void AutomationEngine::publishLocked()
+{
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->lanes.reserve(lanes.size());
+
+    for (const auto& entry : lanes)
+    {
+        Snapshot::Lane lane;
+        lane.parameterID = entry.first;
+        lane.points = entry.second;
+        snapshot->lanes.push_back(std::move(lane));
+    }
+
+    // Si el hilo de audio no llegó a recoger la anterior, nunca la vio
+    std::unique_ptr<Snapshot> neverUsed(pendingSnapshot.exchange(snapshot.release(), std::memory_order_acq_rel));
+}
+
+void AutomationEngine::timerCallback()
+{
+    reclaimRetiredSnapshots();
+}
+
+void AutomationEngine::reclaimRetiredSnapshots()
+{
+    auto scope = retiredFifo.read(retiredFifo.getNumReady());
+    scope.forEach([this](int index)
+    {
+        auto& slot = retiredSnapshots[static_cast<size_t>(index)];
+        delete slot;
+        slot = nullptr;
+    });
+}
+
+//==============================================================================
+void AutomationEngine::addEvent(int sampleOffset, ParameterTable::ParameterID parameterID, float value) noexcept
+{
+    if (plan.numEvents >= maxEventsPerBlock)
+        return;
+
+    // Inserción ordenada por desplazamiento: suele haber muy pocos eventos
+    int index = plan.numEvents++;
+
+    while (index > 0 && events[static_cast<size_t>(index - 1)].sampleOffset > sampleOffset)
+    {
+        events[static_cast<size_t>(index)] = events[static_cast<size_t>(index - 1)];
+        --index;
+    }
+
+    events[static_cast<size_t>(index)] = { sampleOffset, parameterID, value };
+}
+
+const AutomationEngine::BlockPlan& AutomationEngine::planBlock(juce::int64 position, int numSamples) noexcept
+{
+    plan = {};
+    plan.events = events.data();
+    plan.ramps = ramps.data();
+
+    // Adoptar la copia nueva sólo si hay sitio para retirar la actual
+    if (retiredFifo.getFreeSpace() > 0)
+    {
+        if (auto* next = pendingSnapshot.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            if (activeSnapshot != nullptr)
+            {
+                auto scope = retiredFifo.write(1);
+                scope.forEach([this](int index) { retiredSnapshots[static_cast<size_t>(index)] = activeSnapshot; });
+            }
+
+            activeSnapshot = next;
+        }
+    }
+
+    if (activeSnapshot == nullptr || numSamples <= 0)
+        return plan;
+
+    rampScratch.reset();
+
+    const auto blockEnd = position + numSamples;
+
+    for (auto& lane : activeSnapshot->lanes)
+    {
+        if (resyncRequested)
+            lane.hasSentValue = false;
+
+        const int firstSegment = lane.segmentAt(position);
+
+        // ¿Alguno de los tramos que cubren el bloque es una rampa?
+        bool ramping = false;
+        int lastSegment = firstSegment;
+
+        for (;;)
+        {
+            ramping = ramping || lane.isRamp(lastSegment);
+
+            if (lane.segmentEnd(lastSegment) >= blockEnd)
+                break;
+
+            ++lastSegment;
+        }
+
+        if (ramping && plan.numRamps < maxRampsPerBlock)
+        {
+            auto rampBuffer = rampScratch.allocate(1, numSamples);
+
+            if (rampBuffer.getNumChannels() > 0)
+            {
+                auto* values = rampBuffer.getWritePointer(0);
+
+                // Rellenar tramo a tramo: constante o rampa lineal
+                int offset = 0;
+
+                for (int segment = firstSegment; segment <= lastSegment; ++segment)
+                {
+                    const int end = static_cast<int>(juce::jmin(lane.segmentEnd(segment), blockEnd) - position);
+
+                    if (lane.isRamp(segment))
+                    {
+                        const auto& from = lane.points[static_cast<size_t>(segment)];
+                        const auto& to = lane.points[static_cast<size_t>(segment + 1)];
+                        const double slope = (to.value - from.value) / static_cast<double>(to.samplePosition - from.samplePosition);
+                        const auto startDistance = position - from.samplePosition;
+
+                        for (int i = offset; i < end; ++i)
+                            values[i] = from.value + static_cast<float>(slope * static_cast<double>(startDistance + i));
+                    }
+                    else
+                    {
+                        juce::FloatVectorOperations::fill(values + offset, lane.valueAt(segment, position + offset), end - offset);
+                    }
+
+                    offset = end;
+                }
+
+                ramps[static_cast<size_t>(plan.numRamps++)] = { lane.parameterID, values };
+                lane.lastSentValue = values[numSamples - 1];
+                lane.hasSentValue = true;
+                continue;
+            }
+        }
+
+        // Quieto o con saltos: un evento al inicio si cambió y uno por salto
+        float current = lane.valueAt(firstSegment, position);
+
+        if (!lane.hasSentValue || current != lane.lastSentValue)
+            addEvent(0, lane.parameterID, current);
+
+        for (int segment = firstSegment + 1; segment <= lastSegment; ++segment)
+        {
+            const float next = lane.valueAt(segment, lane.points[static_cast<size_t>(segment)].samplePosition);
+
+            if (next != current)
+            {
+                addEvent(static_cast<int>(lane.points[static_cast<size_t>(segment)].samplePosition - position),
+                         lane.parameterID, next);
+                current = next;
+            }
+        }
+
+        lane.lastSentValue = current;
+        lane.hasSentValue = true;
+    }
+
+    resyncRequested = false;
+    return plan;
+}
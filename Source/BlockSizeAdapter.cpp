@@ -0,0 +1,21 @@
+#include "BlockSizeAdapter.h"
+
+void BlockSizeAdapter::prepare(int channels, int internalBlockSize, int deviceBlockSize)
+{
+    numChannels = juce::jmax(1, channels);
+    blockSize = internalBlockSize > 0 ? juce::nextPowerOfTwo(internalBlockSize) : 0;
+    useFifo = blockSize > 0 && (deviceBlockSize <= 0 || deviceBlockSize % blockSize != 0);
+
+    const int storageSize = juce::jmax(1, blockSize);
+    storage.prepare(2 * numChannels, storageSize);
+    fifoBlock = storage.allocate(numChannels, storageSize);
+    outputBlock = storage.allocate(numChannels, storageSize);
+    reset();
+}
+
+void BlockSizeAdapter::reset()
+{
+    fifoBlock.clear();
+    outputBlock.clear();
+    fillPosition = 0;
+}
@@ -1208,6 +1208,29 @@ void DraggableWidget::deleteButtonClicked()
         onDeleteRequested(this);
 }
 
+void DraggableWidget::setParameterTable(ParameterTable* table)
+{
+    parameterTable = table;
+    
+    if (parameterTable != nullptr)
+        registerParameters();
+}
+
+ParameterTable::ParameterID DraggableWidget::registerParameter(const juce::String& valueName, float initialValue)
+{
+    if (parameterTable == nullptr)
+        return ParameterTable::invalidParameterID;
+    
+    // El ID queda fijo aunque después se renombre el widget
+    return parameterTable->registerParameter(widgetName + "/" + valueName, initialValue);
+}
+
+void DraggableWidget::pushParameterValue(ParameterTable::ParameterID parameterID, float value) const
+{
+    if (parameterTable != nullptr)
+        parameterTable->setValue(parameterID, value);
+}
+
 juce::ValueTree DraggableWidget::toValueTree() const
 {
     juce::ValueTree tree("Widget");
@@ -1392,6 +1415,7 @@ DraggableKnob::DraggableKnob(const juce::String& name)
     knob.setValue(0.5);
     knob.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     knob.setLookAndFeel(&knobLookAndFeel);
+    knob.onValueChange = [this]() { pushParameterValue(valueParameterID, static_cast<float>(knob.getValue())); };
     
     // CRÍTICO: Los hijos NO deben interceptar eventos de mouse
     knob.setInterceptsMouseClicks(false, false);
@@ -1442,6 +1466,11 @@ void DraggableKnob::paintWidget(juce::Graphics&)
     label.setColour(juce::Label::textColourId, style.textColor);
 }
 
+void DraggableKnob::registerParameters()
+{
+    valueParameterID = registerParameter("value", static_cast<float>(knob.getValue()));
+}
+
 void DraggableKnob::setWidgetName(const juce::String& newName)
 {
     DraggableWidget::setWidgetName(newName);
@@ -1494,6 +1523,7 @@ DraggableSlider::DraggableSlider(const juce::String& name, bool isVertical)
     slider.setValue(0.5);
     slider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     slider.setLookAndFeel(&sliderLookAndFeel);
+    slider.onValueChange = [this]() { pushParameterValue(valueParameterID, static_cast<float>(slider.getValue())); };
     
     // Los hijos NO deben interceptar eventos de mouse
     slider.setInterceptsMouseClicks(false, false);
@@ -1536,6 +1566,11 @@ void DraggableSlider::paintWidget(juce::Graphics&)
     label.setColour(juce::Label::textColourId, style.textColor);
 }
 
+void DraggableSlider::registerParameters()
+{
+    valueParameterID = registerParameter("value", static_cast<float>(slider.getValue()));
+}
+
 void DraggableSlider::setWidgetName(const juce::String& newName)
 {
     DraggableWidget::setWidgetName(newName);
@@ -2552,9 +2587,17 @@ void DraggableXYPad::updateIndicatorFromMouse(const juce::Point<int>& mousePos)
     yValue = 1.0f - (y - bounds.getY() - indicatorSize/2) / (bounds.getHeight() - indicatorSize);
     
     indicatorPos = juce::Point<float>(x, y);
+    pushParameterValue(xParameterID, xValue);
+    pushParameterValue(yParameterID, yValue);
     repaint();
 }
 
+void DraggableXYPad::registerParameters()
+{
+    xParameterID = registerParameter("x", xValue);
+    yParameterID = registerParameter("y", yValue);
+}
+
 void DraggableXYPad::paintWidget(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().reduced(15).toFloat();
@@ -2955,6 +2998,7 @@ void DraggableXYPad::updateFromMidiValue(int value)
     // Para XY Pad, usar el valor MIDI para controlar el eje X
     // (Se podría asignar otro CC para el eje Y)
     xValue = value / 127.0f;
+    pushParameterValue(xParameterID, xValue);
     repaint();
 }
 
@@ -3039,6 +3083,8 @@ void DraggableJoystick::updateFromMouse(const juce::Point<int>& mousePos)
     stickPos.x = center.x + actualRadius * std::sin(angleRad);
     stickPos.y = center.y - actualRadius * std::cos(angleRad);
     
+    pushParameterValue(radiusParameterID, radius);
+    pushParameterValue(angleParameterID, angle);
     repaint();
 }
 
@@ -3050,9 +3096,17 @@ void DraggableJoystick::returnToCenter()
     auto bounds = getLocalBounds().reduced(20).toFloat();
     stickPos = bounds.getCentre();
     
+    pushParameterValue(radiusParameterID, radius);
+    pushParameterValue(angleParameterID, angle);
     repaint();
 }
 
+void DraggableJoystick::registerParameters()
+{
+    radiusParameterID = registerParameter("radius", radius);
+    angleParameterID = registerParameter("angle", angle);
+}
+
 void DraggableJoystick::paintWidget(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().reduced(20).toFloat();
@@ -3575,6 +3629,7 @@ void DraggableJoystick::updateFromMidiValue(int value)
     stickPos.x = center.x + std::cos(angleRadians) * (radius * maxRadius);
     stickPos.y = center.y + std::sin(angleRadians) * (radius * maxRadius);
     
+    pushParameterValue(radiusParameterID, radius);
     repaint();
 }
 
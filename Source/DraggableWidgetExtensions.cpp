@@ -255,6 +255,7 @@ DraggableVerticalFader::DraggableVerticalFader(const juce::String& name)
 {
     fader = std::make_unique<::VerticalFader>();
     fader->setInterceptsMouseClicks(false, false);
+    fader->onValueChange = [this]() { pushParameterValue(valueParameterID, static_cast<float>(fader->getValue())); };
     addAndMakeVisible(*fader);
     
     label.setText(name, juce::dontSendNotification);
@@ -297,6 +298,12 @@ void DraggableVerticalFader::paintWidget(juce::Graphics& g)
     }
 }
 
+void DraggableVerticalFader::registerParameters()
+{
+    if (fader)
+        valueParameterID = registerParameter("value", static_cast<float>(fader->getValue()));
+}
+
 void DraggableVerticalFader::updateFromMidiValue(int value)
 {
     // Convertir valor MIDI (0-127) al rango del fader
@@ -26,6 +26,13 @@ MainComponent::MainComponent()
     // Configurar consola de depuración
     addAndMakeVisible(debugConsole);
     debugConsole.log("DawMaker 1.0.1 iniciado");
+
+    // Barra de estado con la carga del callback de audio
+    statusBar.setFont(juce::FontOptions(12.0f));
+    statusBar.setColour(juce::Label::backgroundColourId, juce::Colour(0xff0f1626));
+    statusBar.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.8f));
+    addAndMakeVisible(statusBar);
+    startTimer(500);
     
     // Configurar viewport para canvas con scroll
     canvasContainer.setSize(4000, 4000); // Tamaño grande para scroll
@@ -218,6 +225,9 @@ MainComponent::MainComponent()
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+    offlineBounce.reset();
+
     // Desregistrar callback MIDI
     deviceManager.removeMidiInputDeviceCallback(juce::String(), this);
     
@@ -227,7 +237,8 @@ MainComponent::~MainComponent()
 
 void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    
+    callbackMonitor.prepare(sampleRate);
+
     if (audioEngine)
     {
         audioEngine->prepareToPlay(samplesPerBlockExpected, sampleRate);
@@ -236,6 +247,8 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
     // Mezclar el audio del engine (si existe)
     if (audioEngine)
     {
@@ -245,6 +258,8 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
     {
         bufferToFill.clearActiveBufferRegion();
     }
+
+    callbackMonitor.recordCallback(startTicks, juce::Time::getHighResolutionTicks(), bufferToFill.numSamples);
 }
 
 void MainComponent::releaseResources()
@@ -330,7 +345,8 @@ void MainComponent::resized()
     newProjectButton.setBounds(topBar.removeFromRight(80).reduced(4));
     
 
-    // Consola de depuración en la parte inferior (reducida)
+    // Barra de estado y consola de depuración en la parte inferior (reducida)
+    statusBar.setBounds(bounds.removeFromBottom(20));
     auto debugArea = bounds.removeFromBottom(120);
     debugConsole.setBounds(debugArea);
 
@@ -632,6 +648,9 @@ DraggableWidget* MainComponent::addWidget(DraggableWidget::WidgetType type, cons
         showMidiLearnDialog(w);
     };
     
+    // Publicar los valores del widget hacia el hilo de audio
+    widget->setParameterTable(&audioEngine->getParameterTable());
+    
     // Añadir widget al contenedor del canvas (no a MainComponent directamente)
     canvasContainer.addAndMakeVisible(widget.get());
     widgets.add(widget.release());
@@ -745,6 +764,7 @@ void MainComponent::loadLayout()
                                 showMidiLearnDialog(w);
                             };
                             
+                            widget->setParameterTable(&audioEngine->getParameterTable());
                             addAndMakeVisible(widget.get());
                             widgets.add(widget.release());
                         }
@@ -990,6 +1010,7 @@ juce::ValueTree MainComponent::createProjectTree()
     project.setProperty("version", projectProperties.version, nullptr);
     project.setProperty("author", projectProperties.author, nullptr);
     project.setProperty("description", projectProperties.description, nullptr);
+    project.setProperty("lengthSeconds", projectProperties.lengthSeconds, nullptr);
     project.setProperty("creationDate", projectProperties.creationDate.toISO8601(true), nullptr);
     project.setProperty("lastModified", projectProperties.lastModifiedDate.toISO8601(true), nullptr);
     
@@ -1073,6 +1094,7 @@ void MainComponent::loadFromProjectTree(const juce::ValueTree& projectTree)
     projectProperties.version = projectTree.getProperty("version", "1.0.0").toString();
     projectProperties.author = projectTree.getProperty("author", "").toString();
     projectProperties.description = projectTree.getProperty("description", "").toString();
+    projectProperties.lengthSeconds = static_cast<double>(projectTree.getProperty("lengthSeconds", 60.0));
     
     juce::String creationDateStr = projectTree.getProperty("creationDate", "").toString();
     juce::String lastModifiedStr = projectTree.getProperty("lastModified", "").toString();
@@ -1161,6 +1183,7 @@ void MainComponent::loadFromProjectTree(const juce::ValueTree& projectTree)
                 widget->onDeleteRequested = [this](DraggableWidget* w) { removeWidget(w); };
                 widget->onConfigRequested = [this](DraggableWidget* w) { selectWidget(w); };
                 widget->onMidiLearnRequested = [this](DraggableWidget* w) { selectWidget(w); showMidiLearnDialog(w); };
+                widget->setParameterTable(&audioEngine->getParameterTable());
                 addAndMakeVisible(widget.get());
                 widgets.add(widget.release());
             }
@@ -1325,77 +1348,244 @@ void MainComponent::exportToMidi()
     });
 }
 
+namespace
+{
+    /**
+     * Ventana de progreso del bounce: el render corre en su hilo y la ventana
+     * sólo muestra el avance y ofrece cancelar.
+     */
+    class OfflineBounceWindow : public juce::ThreadWithProgressWindow
+    {
+    public:
+        OfflineBounceWindow(AudioEngine& engine, const juce::File& target,
+                            const OfflineRenderer::Settings& renderSettings,
+                            std::function<void(const juce::Result&, const OfflineRenderer::Statistics&)> onFinished)
+            : juce::ThreadWithProgressWindow("Exportando audio...", true, true),
+              renderer(engine), targetFile(target), settings(renderSettings),
+              finishedCallback(std::move(onFinished))
+        {
+        }
+
+        void run() override
+        {
+            result = renderer.render(targetFile, settings, [this](double progress)
+            {
+                setProgress(progress);
+                return !threadShouldExit();
+            });
+        }
+
+        void threadComplete(bool userPressedCancel) override
+        {
+            auto stats = renderer.getStatistics();
+            stats.wasCancelled = stats.wasCancelled || userPressedCancel;
+
+            if (finishedCallback != nullptr)
+                finishedCallback(result, stats);
+        }
+
+    private:
+        OfflineRenderer renderer;
+        juce::File targetFile;
+        OfflineRenderer::Settings settings;
+        std::function<void(const juce::Result&, const OfflineRenderer::Statistics&)> finishedCallback;
+        juce::Result result { juce::Result::ok() };
+    };
+}
+
 void MainComponent::exportToAudio()
 {
-    auto chooser = std::make_shared<juce::FileChooser>(
+    if (offlineBounce != nullptr)
+    {
+        debugConsole.log("Ya hay una exportacion de audio en curso");
+        return;
+    }
+
+    if (audioEngine == nullptr || audioEngine->getCurrentSampleRate() <= 0.0)
+    {
+        debugConsole.log("ERROR: Configura un dispositivo de audio antes de exportar", true);
+        return;
+    }
+
+    // Opciones del bounce: duración (por defecto la del proyecto) y resolución
+    auto* w = new juce::AlertWindow(
         "Exportar Audio",
-        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory),
-        "*.wav"
+        "Render offline del grafo de audio a " + juce::String(audioEngine->getCurrentSampleRate(), 0) + " Hz",
+        juce::MessageBoxIconType::QuestionIcon
     );
-    
-    auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles;
-    
-    chooser->launchAsync(flags, [this, chooser](const juce::FileChooser& fc)
+
+    w->addTextEditor("length", juce::String(projectProperties.lengthSeconds, 1), "Duracion (segundos):");
+    w->addComboBox("bits", { "16 bits", "24 bits", "32 bits float" }, "Resolucion:");
+    w->getComboBoxComponent("bits")->setSelectedItemIndex(1);
+
+    w->addButton("Exportar", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    w->addButton("Cancelar", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    w->enterModalState(true, juce::ModalCallbackFunction::create([this, w](int result)
     {
-        auto file = fc.getResult();
-        if (file != juce::File())
+        if (result != 1)
+            return;
+
+        OfflineRenderer::Settings settings;
+        settings.lengthSeconds = w->getTextEditorContents("length").getDoubleValue();
+
+        const int bitDepths[] = { 16, 24, 32 };
+        settings.bitsPerSample = bitDepths[juce::jlimit(0, 2, w->getComboBoxComponent("bits")->getSelectedItemIndex())];
+
+        if (settings.lengthSeconds <= 0.0)
         {
+            debugConsole.log("ERROR: Duracion de exportacion no valida", true);
+            return;
+        }
+
+        projectProperties.lengthSeconds = settings.lengthSeconds;
+
+        auto chooser = std::make_shared<juce::FileChooser>(
+            "Exportar Audio",
+            exportPaths.audioPath.isDirectory() ? exportPaths.audioPath
+                                                : juce::File::getSpecialLocation(juce::File::userDocumentsDirectory),
+            "*.wav"
+        );
+
+        auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles;
+
+        chooser->launchAsync(flags, [this, chooser, settings](const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
             if (!file.hasFileExtension(".wav"))
                 file = file.withFileExtension(".wav");
-            
-            // Parámetros de audio
-            const int sampleRate = 44100;
-            const int numChannels = 2;
-            const int duration = 10; // 10 segundos
-            const int numSamples = sampleRate * duration;
-            
-            // Crear buffer de audio
-            juce::AudioBuffer<float> buffer(numChannels, numSamples);
-            buffer.clear();
-            
-            // Generar audio simple (tono de prueba)
-            for (int channel = 0; channel < numChannels; ++channel)
+
+            startOfflineBounce(file, settings);
+        });
+    }), true);
+}
+
+void MainComponent::startOfflineBounce(const juce::File& file, const OfflineRenderer::Settings& settings)
+{
+    if (offlineBounce != nullptr)
+        return;
+
+    debugConsole.log("Exportando " + juce::String(settings.lengthSeconds, 1) + " s de audio a "
+                     + file.getFullPathName() + " (la salida en vivo queda en silencio)");
+
+    juce::Component::SafePointer<MainComponent> safeThis(this);
+
+    offlineBounce = std::make_unique<OfflineBounceWindow>(*audioEngine, file, settings,
+        [safeThis, file](const juce::Result& result, const OfflineRenderer::Statistics& stats)
+        {
+            if (safeThis == nullptr)
+                return;
+
+            auto& self = *safeThis;
+
+            if (result.failed())
             {
-                auto* channelData = buffer.getWritePointer(channel);
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    // Tono de 440 Hz (A4)
-                    channelData[i] = std::sin(2.0f * juce::MathConstants<float>::pi * 440.0f * i / sampleRate) * 0.5f;
-                }
+                self.debugConsole.log("ERROR: " + result.getErrorMessage(), true);
             }
-            
-            // Escribir archivo WAV
-            std::unique_ptr<juce::AudioFormatWriter> writer;
-            juce::WavAudioFormat wavFormat;
-            
-            juce::FileOutputStream* outputStream = new juce::FileOutputStream(file);
-            if (outputStream->openedOk())
+            else if (stats.wasCancelled)
             {
-                writer.reset(wavFormat.createWriterFor(outputStream, sampleRate, numChannels, 16, {}, 0));
-                if (writer != nullptr)
-                {
-                    writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
-                    writer.reset();
-                    
-                    debugConsole.log("Audio exportado exitosamente: " + file.getFullPathName());
-                    juce::NativeMessageBox::showMessageBoxAsync(
-                        juce::MessageBoxIconType::InfoIcon,
-                        "Exportación Audio",
-                        "Archivo de audio exportado exitosamente\\n10 segundos @ 44.1kHz"
-                    );
-                }
-                else
-                {
-                    debugConsole.log("ERROR: No se pudo crear el escritor de audio");
-                    delete outputStream;
-                }
+                self.debugConsole.log("Exportacion de audio cancelada");
             }
             else
             {
-                debugConsole.log("ERROR: No se pudo abrir el archivo para escritura");
-                delete outputStream;
+                const juce::String summary = juce::String(stats.elapsedSeconds, 2) + " s de render, "
+                                           + juce::String(stats.realtimeFactor, 1) + "x tiempo real";
+
+                self.debugConsole.log("Audio exportado exitosamente: " + file.getFullPathName() + " (" + summary + ")");
+                juce::NativeMessageBox::showMessageBoxAsync(
+                    juce::MessageBoxIconType::InfoIcon,
+                    "Exportación Audio",
+                    "Archivo de audio exportado exitosamente\n" + summary
+                );
             }
-        }
+
+            // La ventana no puede destruirse dentro de su propio callback
+            juce::MessageManager::callAsync([safeThis]()
+            {
+                if (safeThis != nullptr)
+                    safeThis->offlineBounce.reset();
+            });
+        });
+
+    offlineBounce->launchThread();
+}
+
+// Monitor de carga del callback de audio
+void MainComponent::timerCallback()
+{
+    const auto snapshot = callbackMonitor.getSnapshot();
+    const int deviceXRuns = getDeviceXRunCount();
+
+    juce::String text;
+    text << "DSP " << juce::String(snapshot.lastLoadPercent, 1) << "%"
+         << " | media " << juce::String(snapshot.averageLoadPercent, 1) << "%"
+         << " | pico " << juce::String(snapshot.worst.deadlineMs > 0.0 ? snapshot.worst.durationMs * 100.0 / snapshot.worst.deadlineMs : 0.0, 1) << "%"
+         << " | excesos DSP " << juce::String(snapshot.numOverruns)
+         << " | xruns dispositivo " << (deviceXRuns >= 0 ? juce::String(deviceXRuns) : juce::String("n/d"));
+
+    if (audioEngine != nullptr && audioEngine->getCurrentSampleRate() > 0.0)
+        text << " | latencia PDC " << juce::String(1000.0 * audioEngine->getOutputLatencySamples() / audioEngine->getCurrentSampleRate(), 1) << " ms";
+
+    if (audioEngine != nullptr && audioEngine->getGraph().getNumActiveSequenceNodes() > 0)
+        text << " | nodos dormidos " << juce::String(audioEngine->getGraph().getNumSleepingNodes())
+             << "/" << juce::String(audioEngine->getGraph().getNumActiveSequenceNodes());
+    statusBar.setText(text, juce::dontSendNotification);
+
+    if (snapshot.numOverruns > lastReportedOverruns)
+    {
+        debugConsole.log("ADVERTENCIA: " + juce::String(snapshot.numOverruns - lastReportedOverruns)
+                         + " callback(s) de audio excedieron su plazo (peor: "
+                         + juce::String(snapshot.worst.durationMs, 3) + " ms de "
+                         + juce::String(snapshot.worst.deadlineMs, 3) + " ms)", true);
+    }
+
+    lastReportedOverruns = snapshot.numOverruns;
+}
+
+int MainComponent::getDeviceXRunCount()
+{
+    auto* device = deviceManager.getCurrentAudioDevice();
+    return device != nullptr ? device->getXRunCount() : -1;
+}
+
+void MainComponent::logCallbackReport()
+{
+    const auto report = AudioCallbackMonitor::describe(callbackMonitor.getSnapshot(), getDeviceXRunCount());
+
+    debugConsole.log("Informe de carga del callback de audio:");
+    for (const auto& line : juce::StringArray::fromLines(report.trimEnd()))
+        debugConsole.log("  " + line);
+}
+
+void MainComponent::exportCallbackReport()
+{
+    // Tomar la instantánea al pedir el informe, no al elegir el archivo
+    const auto csv = AudioCallbackMonitor::toCSV(callbackMonitor.getSnapshot(), getDeviceXRunCount());
+
+    auto chooser = std::make_shared<juce::FileChooser>(
+        "Exportar Informe de Carga",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("callback_report.csv"),
+        "*.csv"
+    );
+
+    auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles;
+
+    chooser->launchAsync(flags, [this, chooser, csv](const juce::FileChooser& fc)
+    {
+        auto file = fc.getResult();
+        if (file == juce::File())
+            return;
+
+        if (!file.hasFileExtension(".csv"))
+            file = file.withFileExtension(".csv");
+
+        if (file.replaceWithText(csv))
+            debugConsole.log("Informe de carga exportado: " + file.getFullPathName());
+        else
+            debugConsole.log("ERROR: No se pudo escribir el informe de carga", true);
     });
 }
 
@@ -1597,6 +1787,18 @@ juce::PopupMenu MainComponent::getMenuForIndex(int topLevelMenuIndex, const juce
         juce::PopupMenu audioMidiMenu;
         audioMidiMenu.addItem(5001, "Configuracion Audio");
         audioMidiMenu.addItem(5002, "Configuracion MIDI");
+        audioMidiMenu.addSeparator();
+        audioMidiMenu.addItem(5010, "Informe de Carga de Audio");
+        audioMidiMenu.addItem(5011, "Exportar Informe de Carga...");
+        audioMidiMenu.addItem(5012, "Reiniciar Monitor de Carga");
+        audioMidiMenu.addSeparator();
+
+        juce::PopupMenu blockSizeMenu;
+        const int currentInternalBlock = audioEngine != nullptr ? audioEngine->getInternalBlockSize() : 0;
+        blockSizeMenu.addItem(5020, "Igual que el dispositivo", true, currentInternalBlock == 0);
+        for (int i = 0; i < 5; ++i)
+            blockSizeMenu.addItem(5021 + i, juce::String(64 << i) + " muestras", true, currentInternalBlock == (64 << i));
+        audioMidiMenu.addSubMenu("Bloque Interno de Proceso", blockSizeMenu);
         menu.addSubMenu("Audio/MIDI", audioMidiMenu);
         
         juce::PopupMenu gridMenu;
@@ -1811,6 +2013,32 @@ void MainComponent::menuItemSelected(int menuItemID, int topLevelMenuIndex)
     // Settings - Audio/MIDI
     else if (menuItemID == 5001) showAudioSettings();
     else if (menuItemID == 5002) debugConsole.log("Configuración MIDI - En desarrollo");
+    else if (menuItemID == 5010) logCallbackReport();
+    else if (menuItemID == 5011) exportCallbackReport();
+    else if (menuItemID >= 5020 && menuItemID <= 5025)
+    {
+        if (audioEngine != nullptr)
+        {
+            const int newBlockSize = menuItemID == 5020 ? 0 : (64 << (menuItemID - 5021));
+            audioEngine->setInternalBlockSize(newBlockSize);
+
+            // Reabrir el dispositivo para que prepareToPlay aplique el cambio:
+            // restartLastAudioDevice sólo reabre un dispositivo ya cerrado. Al
+            // volver, prepareToPlay ya ha corrido y los valores son los nuevos.
+            deviceManager.closeAudioDevice();
+            deviceManager.restartLastAudioDevice();
+
+            debugConsole.log("Bloque interno: " + juce::String(audioEngine->getProcessingBlockSize())
+                             + " muestras, latencia de adaptacion "
+                             + juce::String(audioEngine->getBlockAdapterLatencySamples()) + " muestras");
+        }
+    }
+    else if (menuItemID == 5012)
+    {
+        callbackMonitor.reset();
+        lastReportedOverruns = 0;
+        debugConsole.log("Monitor de carga de audio reiniciado");
+    }
     
     // Settings - Grid
     else if (menuItemID == 5003) { showGrid = !showGrid; repaint(); }
@@ -1937,7 +2165,8 @@ void MainComponent::showProjectProperties()
     message += "Nombre: " + projectProperties.name + "\n";
     message += "Autor: " + projectProperties.author + "\n";
     message += "Versión: " + projectProperties.version + "\n";
-    message += "Descripción: " + projectProperties.description + "\n\n";
+    message += "Descripción: " + projectProperties.description + "\n";
+    message += "Duración: " + juce::String(projectProperties.lengthSeconds, 1) + " s\n\n";
     message += "Creado: " + projectProperties.creationDate.toString(true, true) + "\n";
     message += "Modificado: " + projectProperties.lastModifiedDate.toString(true, true) + "\n\n";
     message += "Para editar las propiedades, use un editor de texto\ny modifique el archivo .dawproj directamente.";
@@ -0,0 +1,104 @@
+#include "OfflineRenderer.h"
+
+OfflineRenderer::OfflineRenderer(AudioEngine& engineToRender)
+    : engine(engineToRender)
+{
+}
+
+juce::Result OfflineRenderer::render(const juce::File& targetFile, const Settings& settings,
+                                     const std::function<bool(double progress)>& progressCallback)
+{
+    statistics = {};
+
+    const double sampleRate = engine.getCurrentSampleRate();
+
+    if (sampleRate <= 0.0)
+        return juce::Result::fail("El motor de audio no esta preparado (sin dispositivo activo)");
+
+    if (settings.lengthSeconds <= 0.0)
+        return juce::Result::fail("La duracion del render debe ser mayor que cero");
+
+    // Escribir en un temporal junto al destino; sólo se mueve al terminar
+    juce::TemporaryFile tempFile(targetFile);
+
+    auto outputStream = std::make_unique<juce::FileOutputStream>(tempFile.getFile(), 1 << 20);
+
+    if (!outputStream->openedOk())
+        return juce::Result::fail("No se pudo abrir el archivo para escritura: " + tempFile.getFile().getFullPathName());
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), sampleRate,
+                                                                              static_cast<unsigned int>(AudioEngine::numChannels),
+                                                                              settings.bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+        return juce::Result::fail("No se pudo crear el escritor WAV (" + juce::String(settings.bitsPerSample) + " bits)");
+
+    outputStream.release(); // ahora es propiedad del writer
+
+    if (!engine.beginOfflineRender())
+        return juce::Result::fail("Ya hay un render offline en curso");
+
+    const auto totalSamples = static_cast<juce::int64>(settings.lengthSeconds * sampleRate + 0.5);
+    const int blockSize = juce::jmax(1, settings.blockSize);
+
+    // Descartar la latencia del grafo para que el archivo empiece alineado
+    // (el render offline no pasa por el adaptador de bloque interno)
+    auto samplesToSkip = static_cast<juce::int64>(engine.getGraphLatencySamples());
+
+    // El único buffer del render: la memoria no crece con la duración
+    juce::AudioBuffer<float> block(AudioEngine::numChannels, blockSize);
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    bool writeFailed = false;
+
+    while (statistics.samplesWritten < totalSamples)
+    {
+        const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize),
+                                                           totalSamples - statistics.samplesWritten));
+
+        engine.renderOfflineBlock(block, numSamples);
+
+        const int skipped = static_cast<int>(juce::jmin(samplesToSkip, static_cast<juce::int64>(numSamples)));
+        samplesToSkip -= skipped;
+
+        if (skipped == numSamples)
+            continue;
+
+        if (!writer->writeFromAudioSampleBuffer(block, skipped, numSamples - skipped))
+        {
+            writeFailed = true;
+            break;
+        }
+
+        statistics.samplesWritten += numSamples - skipped;
+
+        if (progressCallback != nullptr
+            && !progressCallback(static_cast<double>(statistics.samplesWritten) / static_cast<double>(totalSamples)))
+        {
+            statistics.wasCancelled = true;
+            break;
+        }
+    }
+
+    engine.endOfflineRender();
+
+    statistics.elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    statistics.realtimeFactor = statistics.elapsedSeconds > 0.0
+                                  ? (static_cast<double>(statistics.samplesWritten) / sampleRate) / statistics.elapsedSeconds
+                                  : 0.0;
+
+    // Cerrar el writer completa la cabecera WAV antes de mover el archivo
+    writer.reset();
+
+    if (writeFailed)
+        return juce::Result::fail("Error de escritura en disco tras " + juce::String(statistics.samplesWritten) + " muestras");
+
+    if (statistics.wasCancelled)
+        return juce::Result::ok(); // el temporal se borra al salir
+
+    if (!tempFile.overwriteTargetFileWithTemporary())
+        return juce::Result::fail("No se pudo mover el render a " + targetFile.getFullPathName());
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,53 @@
+#include "ParameterTable.h"
+
+ParameterTable::ParameterTable()
+    : values(new std::atomic<float>[maxParameters])
+{
+    for (int i = 0; i < maxParameters; ++i)
+        values[static_cast<size_t>(i)].store(0.0f, std::memory_order_relaxed);
+
+    for (auto& word : changedWords)
+        word.store(0, std::memory_order_relaxed);
+
+    for (auto& word : summaryWords)
+        word.store(0, std::memory_order_relaxed);
+}
+
+ParameterTable::ParameterID ParameterTable::registerParameter(const juce::String& key, float initialValue)
+{
+    const juce::ScopedLock sl(registryLock);
+
+    // Una clave repetida (p. ej. un widget nuevo o recargado con el nombre de
+    // uno borrado) reutiliza el ID pero no el valor viejo
+    auto existing = idsByKey.find(key);
+    if (existing != idsByKey.end())
+    {
+        setValue(existing->second, initialValue);
+        return existing->second;
+    }
+
+    const int parameterID = numParameters.load(std::memory_order_relaxed);
+
+    if (parameterID >= maxParameters)
+    {
+        juce::Logger::writeToLog("ParameterTable: tabla llena, no se pudo registrar " + key);
+        return invalidParameterID;
+    }
+
+    values[static_cast<size_t>(parameterID)].store(initialValue, std::memory_order_relaxed);
+    idsByKey[key] = parameterID;
+
+    // Publicar el nuevo tamaño después de inicializar el valor
+    numParameters.store(parameterID + 1, std::memory_order_release);
+    setValue(parameterID, initialValue);
+
+    return parameterID;
+}
+
+ParameterTable::ParameterID ParameterTable::findParameter(const juce::String& key) const
+{
+    const juce::ScopedLock sl(registryLock);
+
+    auto existing = idsByKey.find(key);
+    return existing != idsByKey.end() ? existing->second : invalidParameterID;
+}